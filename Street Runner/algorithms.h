@@ -0,0 +1,97 @@
+#ifndef STREET_RUNNER_ALGORITHMS_H
+#define STREET_RUNNER_ALGORITHMS_H
+
+#include <cmath>
+#include <algorithm>
+
+/* ========================================================================
+   CUSTOM ALGORITHMS
+   ========================================================================
+   The DDA line and midpoint circle generators write their points into a
+   vertex sink instead of calling GL directly, so the same code feeds the
+   GL renderer and GPU-less consumers (benchmarks, counting). A sink
+   provides:
+
+       void begin();                       start of a GL_POINTS batch
+       void vertex(float x, float y, float z);
+       void end();
+   ======================================================================== */
+
+template <class Sink>
+void emitLineDDA(Sink& out,
+                 float x1, float y1, float z1,
+                 float x2, float y2, float z2) {
+
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float dz = z2 - z1;
+
+    float steps = std::max(std::abs(dx),
+                   std::max(std::abs(dy), std::abs(dz)));
+
+    if (steps == 0) {
+        out.begin();
+        out.vertex(x1, y1, z1);
+        out.end();
+        return;
+    }
+
+    float xInc = dx / steps;
+    float yInc = dy / steps;
+    float zInc = dz / steps;
+
+    float x = x1, y = y1, z = z1;
+
+    out.begin();
+    for (int i = 0; i <= steps; i++) {
+        out.vertex(x, y, z);
+        x += xInc;
+        y += yInc;
+        z += zInc;
+    }
+    out.end();
+}
+
+template <class Sink>
+void emitMidpointCirclePoints(Sink& out, int radius, float pixelScale) {
+
+    int x = 0;
+    int y = radius;
+    int p = 1 - radius;
+
+    out.begin();
+
+    while (x <= y) {
+
+        float fx = x * pixelScale;
+        float fy = y * pixelScale;
+
+        out.vertex( fx,  fy, 0);
+        out.vertex( fy,  fx, 0);
+        out.vertex(-fx,  fy, 0);
+        out.vertex(-fy,  fx, 0);
+        out.vertex(-fx, -fy, 0);
+        out.vertex(-fy, -fx, 0);
+        out.vertex( fx, -fy, 0);
+        out.vertex( fy, -fx, 0);
+
+        x++;
+
+        if (p < 0)
+            p += 2 * x + 1;
+        else {
+            y--;
+            p += 2 * x - 2 * y + 1;
+        }
+    }
+
+    out.end();
+}
+
+template <class Sink>
+void emitFilledMidpointCircle(Sink& out, int radius, float scale) {
+    for (int r = 0; r <= radius; r++)
+        emitMidpointCirclePoints(out, r, scale);
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef STREET_RUNNER_BENCH_H
+#define STREET_RUNNER_BENCH_H
+
+#include <chrono>
+#include <vector>
+
+/* ========================================================================
+   MINIMAL BENCHMARK HARNESS
+   ========================================================================
+   Each benchmark receives the iteration count to run and may report how
+   many items one iteration processes. The runner grows the count until
+   a run takes at least --min-time seconds and prints one JSON object per
+   benchmark (ns/op, items/sec) so results can be diffed between commits.
+   ======================================================================== */
+
+struct Bench {
+
+    long iterations = 1;
+    double itemsPerIteration = 1.0;
+
+    /* Restarts the clock; call after per-run setup. */
+    void resetTimer() { start = std::chrono::steady_clock::now(); }
+
+    /* Excludes a section (e.g. re-seeding state) from the measurement. */
+    void pauseTimer() { pausedAt = std::chrono::steady_clock::now(); }
+    void resumeTimer() {
+        start += std::chrono::steady_clock::now() - pausedAt;
+    }
+
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point pausedAt;
+};
+
+typedef void (*BenchFn)(Bench&);
+
+struct BenchEntry {
+    const char* name;
+    BenchFn fn;
+};
+
+std::vector<BenchEntry>& benchRegistry();
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, BenchFn fn) {
+        benchRegistry().push_back({ name, fn });
+    }
+};
+
+#define BENCH_CONCAT2(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT2(a, b)
+
+#define BENCHMARK(name, fn) \
+    static BenchRegistrar BENCH_CONCAT(benchRegistrar_, __LINE__)(name, fn)
+
+/* Keeps a value alive so the optimiser cannot drop the work behind it. */
+template <class T>
+inline void keep(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif
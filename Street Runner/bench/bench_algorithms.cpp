@@ -0,0 +1,61 @@
+#include "bench.h"
+#include "../algorithms.h"
+
+/* ========================================================================
+   VERTEX GENERATION BENCHMARKS
+   ========================================================================
+   The generators run against a counting sink, so these measure the CPU
+   side of drawLineDDA / drawMidpointCirclePoints without a GPU.
+   ======================================================================== */
+
+struct CountingSink {
+    long batches = 0;
+    long vertices = 0;
+    float checksum = 0.0f;
+
+    void begin() { batches++; }
+    void vertex(float x, float y, float z) {
+        vertices++;
+        checksum += x + y + z;
+    }
+    void end() {}
+};
+
+/* One of the lane markings drawWorld() emits per even segment. */
+static void benchLineDDA(Bench& b) {
+    CountingSink sink;
+    for (long i = 0; i < b.iterations; i++)
+        emitLineDDA(sink, -1.0f, 0.02f, 0.0f, -1.0f, 0.02f, -2.0f);
+    b.itemsPerIteration = (double)sink.vertices / b.iterations;
+    keep(sink.checksum);
+}
+BENCHMARK("line_dda", benchLineDDA);
+
+/* A long diagonal, closer to the cartoon house outlines after scaling. */
+static void benchLineDDALong(Bench& b) {
+    CountingSink sink;
+    for (long i = 0; i < b.iterations; i++)
+        emitLineDDA(sink, -120.0f, 0.0f, 0.0f, 120.0f, 80.0f, -40.0f);
+    b.itemsPerIteration = (double)sink.vertices / b.iterations;
+    keep(sink.checksum);
+}
+BENCHMARK("line_dda_long", benchLineDDALong);
+
+static void benchCirclePoints(Bench& b) {
+    CountingSink sink;
+    for (long i = 0; i < b.iterations; i++)
+        emitMidpointCirclePoints(sink, 35, 1.0f);
+    b.itemsPerIteration = (double)sink.vertices / b.iterations;
+    keep(sink.checksum);
+}
+BENCHMARK("midpoint_circle_r35", benchCirclePoints);
+
+/* The sun disc in drawAttractiveBackground(). */
+static void benchFilledCircle(Bench& b) {
+    CountingSink sink;
+    for (long i = 0; i < b.iterations; i++)
+        emitFilledMidpointCircle(sink, 60, 1.0f);
+    b.itemsPerIteration = (double)sink.vertices / b.iterations;
+    keep(sink.checksum);
+}
+BENCHMARK("filled_circle_r60", benchFilledCircle);
@@ -0,0 +1,59 @@
+#include "bench.h"
+#include "../capture.h"
+
+#include <vector>
+
+/* ========================================================================
+   CAPTURE BENCHMARKS
+   ========================================================================
+   One 1080p RGBA frame per iteration; items_per_sec is frames per
+   second. The conversions are what the encoder thread does per frame;
+   the pipeline benchmark submits raw frames that the encoder writes to
+   /dev/null, waiting on a full ring instead of dropping, so it is the
+   frame rate capture can sustain without drops.
+   ======================================================================== */
+
+static const int captureWidth = 1920;
+static const int captureHeight = 1080;
+
+static const std::vector<uint8_t>& testFrame() {
+    static std::vector<uint8_t> frame;
+    if (frame.empty()) {
+        frame.resize((size_t)captureWidth * captureHeight * 4);
+        for (size_t i = 0; i < frame.size(); i++)
+            frame[i] = (uint8_t)(i * 2654435761u >> 24);
+    }
+    return frame;
+}
+
+static void benchYuv420(Bench& b) {
+    std::vector<uint8_t> out;
+    const uint8_t* frame = testFrame().data();
+    b.resetTimer();
+    for (long i = 0; i < b.iterations; i++)
+        rgbaToYuv420(frame, captureWidth, captureHeight, true, out);
+    keep(out[out.size() / 2]);
+}
+BENCHMARK("capture_yuv420_1080p", benchYuv420);
+
+static void benchPNG(Bench& b) {
+    std::vector<uint8_t> out;
+    const uint8_t* frame = testFrame().data();
+    b.resetTimer();
+    for (long i = 0; i < b.iterations; i++)
+        encodePNG(frame, captureWidth, captureHeight, true, out);
+    keep(out[out.size() / 2]);
+}
+BENCHMARK("capture_png_1080p", benchPNG);
+
+static void benchPipeline(Bench& b) {
+    FrameEncoder encoder(CAPTURE_RAW, "/dev/null",
+                         captureWidth, captureHeight);
+    const uint8_t* frame = testFrame().data();
+    b.resetTimer();
+    for (long i = 0; i < b.iterations; i++)
+        encoder.submit(frame, true, true);
+    encoder.finish();
+    keep(encoder.stats().written);
+}
+BENCHMARK("capture_pipeline_raw_1080p", benchPipeline);
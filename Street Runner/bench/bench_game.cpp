@@ -0,0 +1,162 @@
+#include "bench.h"
+#include "../game.h"
+#include "../traffic.h"
+#include "../spatial.h"
+
+/* ========================================================================
+   GAME LOGIC BENCHMARKS
+   ======================================================================== */
+
+static void benchHash32(Bench& b) {
+    uint32_t acc = 0;
+    for (long i = 0; i < b.iterations; i++)
+        acc += hash32((uint32_t)i ^ 0xA53C9E11U);
+    keep(acc);
+}
+BENCHMARK("hash32", benchHash32);
+
+/* The game prunes cars and coins as they pass the camera; here the
+   pool and coin list are emptied every window instead. */
+static void benchSpawn(Bench& b) {
+
+    const long window = visibleSegments + 60;
+
+    clearTraffic();
+    coins.clear();
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++) {
+        if (i % window == 0) {
+            b.pauseTimer();
+            clearTraffic();
+            coins.clear();
+            b.resumeTimer();
+        }
+        spawn(i);
+    }
+    keep(traffic.count + coins.size());
+}
+BENCHMARK("spawn", benchSpawn);
+
+static void benchCollisions(Bench& b) {
+
+    highScoreFile = nullptr;
+    resetGame();
+    currentSegment = 5;
+    markItemsMoved(ITEM_ALL);
+    b.itemsPerIteration = (double)(traffic.count + coins.size());
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++) {
+        mode = PLAYING;
+        currentLane = (int)(i % laneCount);
+        checkCollisions();
+    }
+    keep(coinScore);
+}
+BENCHMARK("update_collisions", benchCollisions);
+
+static void benchHeadlessTick(Bench& b) {
+
+    highScoreFile = nullptr;
+    resetGame();
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++) {
+        tickGame();
+        if (mode == GAMEOVER) {
+            b.pauseTimer();
+            resetGame();
+            b.resumeTimer();
+        }
+    }
+    keep(distanceScore);
+}
+BENCHMARK("tick_headless", benchHeadlessTick);
+
+/* ========================================================================
+   TRAFFIC STRESS
+   ========================================================================
+   64 lanes at 60% density: a few thousand moving cars. The pool is
+   respawned every 200 ticks so it does not run dry; items_per_sec is
+   cars per second.
+   ======================================================================== */
+
+static void resetStress() {
+    setLaneCount(64);
+    carDensity = 60;
+    highScoreFile = nullptr;
+    resetGame();
+}
+
+static void restoreClassic() {
+    setLaneCount(3);
+    carDensity = 15;
+    resetGame();
+}
+
+static void benchTrafficUpdate(Bench& b) {
+
+    resetStress();
+    b.itemsPerIteration = traffic.count;
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++) {
+        if (i % 200 == 199) {
+            b.pauseTimer();
+            resetGame();
+            b.resumeTimer();
+        }
+        updateTraffic();
+    }
+    keep(traffic.z[0]);
+
+    restoreClassic();
+}
+BENCHMARK("traffic_update_64lanes", benchTrafficUpdate);
+
+static void benchTrafficTick(Bench& b) {
+
+    resetStress();
+    b.itemsPerIteration = traffic.count;
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++) {
+        tickGame();
+        if (mode == GAMEOVER) {
+            b.pauseTimer();
+            resetGame();
+            b.resumeTimer();
+        }
+    }
+    keep(distanceScore);
+
+    restoreClassic();
+}
+BENCHMARK("tick_headless_64lanes", benchTrafficTick);
+
+/* Every lane but the free one wants a car, so each segment spawned
+   places over sixty cars and works their rows into the reachability
+   check. */
+static void benchTrafficTickDense(Bench& b) {
+
+    setLaneCount(64);
+    carDensity = 100;
+    highScoreFile = nullptr;
+    resetGame();
+    b.itemsPerIteration = traffic.count;
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++) {
+        tickGame();
+        if (mode == GAMEOVER) {
+            b.pauseTimer();
+            resetGame();
+            b.resumeTimer();
+        }
+    }
+    keep(distanceScore + droppedCars);
+
+    restoreClassic();
+}
+BENCHMARK("tick_headless_64lanes_dense", benchTrafficTickDense);
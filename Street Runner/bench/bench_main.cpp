@@ -0,0 +1,82 @@
+#include "bench.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/* ========================================================================
+   RUNNER
+   ========================================================================
+   Usage: street_runner_bench [--filter=SUBSTR] [--min-time=SEC] [--list]
+
+   Output is one JSON object per line:
+   {"name":..., "iterations":..., "ns_per_op":..., "items_per_sec":...}
+   ======================================================================== */
+
+std::vector<BenchEntry>& benchRegistry() {
+    static std::vector<BenchEntry> entries;
+    return entries;
+}
+
+static double runOnce(const BenchEntry& e, Bench& b) {
+    b.resetTimer();
+    e.fn(b);
+    std::chrono::duration<double> dt =
+        std::chrono::steady_clock::now() - b.start;
+    return dt.count();
+}
+
+int main(int argc, char** argv) {
+
+    const char* filter = nullptr;
+    double minTime = 0.25;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!std::strncmp(argv[i], "--filter=", 9))
+            filter = argv[i] + 9;
+        else if (!std::strncmp(argv[i], "--min-time=", 11))
+            minTime = std::atof(argv[i] + 11);
+        else if (!std::strcmp(argv[i], "--list"))
+            listOnly = true;
+        else {
+            std::fprintf(stderr,
+                "usage: %s [--filter=SUBSTR] [--min-time=SEC] [--list]\n",
+                argv[0]);
+            return 2;
+        }
+    }
+
+    for (const BenchEntry& e : benchRegistry()) {
+
+        if (filter && !std::strstr(e.name, filter))
+            continue;
+
+        if (listOnly) {
+            std::printf("%s\n", e.name);
+            continue;
+        }
+
+        Bench b;
+        b.iterations = 1;
+        double seconds = runOnce(e, b);
+
+        while (seconds < minTime && b.iterations < (1L << 40)) {
+            double grow = seconds > 0.0 ? minTime * 1.4 / seconds : 10.0;
+            grow = grow < 2.0 ? 2.0 : (grow > 10.0 ? 10.0 : grow);
+            b.iterations = (long)(b.iterations * grow);
+            seconds = runOnce(e, b);
+        }
+
+        double nsPerOp = seconds * 1e9 / b.iterations;
+        double itemsPerSec =
+            b.iterations * b.itemsPerIteration / seconds;
+
+        std::printf("{\"name\":\"%s\",\"iterations\":%ld,"
+                    "\"ns_per_op\":%.3f,\"items_per_sec\":%.1f}\n",
+                    e.name, b.iterations, nsPerOp, itemsPerSec);
+        std::fflush(stdout);
+    }
+
+    return 0;
+}
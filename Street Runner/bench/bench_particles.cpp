@@ -0,0 +1,57 @@
+#include "bench.h"
+#include "../particles.h"
+
+/* ========================================================================
+   PARTICLE BENCHMARKS
+   ========================================================================
+   The pool is topped back up to capacity (8192 live particles) before
+   every timed update, so items_per_sec is particles per second and
+   ns_per_op is the per-frame cost at full load, deaths included.
+   ======================================================================== */
+
+static void fillPool() {
+    while (particles.count < maxParticles)
+        emitCrashDebris(0.0f, 0.5f, 0.0f);
+}
+
+static void benchParticleUpdate(Bench& b) {
+    clearParticles();
+    b.itemsPerIteration = maxParticles;
+    b.resetTimer();
+    for (long i = 0; i < b.iterations; i++) {
+        b.pauseTimer();
+        fillPool();
+        b.resumeTimer();
+        updateParticles(0.15f);
+    }
+    keep(particles.y[maxParticles / 2]);
+}
+BENCHMARK("particles_update_8192", benchParticleUpdate);
+
+static void benchParticlePack(Bench& b) {
+    static float xyz[maxParticles * 3], rgba[maxParticles * 4];
+    clearParticles();
+    fillPool();
+    b.itemsPerIteration = maxParticles;
+    b.resetTimer();
+    int n = 0;
+    for (long i = 0; i < b.iterations; i++)
+        n += packParticles(xyz, rgba);
+    keep(n);
+    keep(rgba[7]);
+}
+BENCHMARK("particles_pack_8192", benchParticlePack);
+
+/* Steady-state churn: the pool refills as old particles die. */
+static void benchParticleChurn(Bench& b) {
+    clearParticles();
+    b.resetTimer();
+    for (long i = 0; i < b.iterations; i++) {
+        emitCoinSparkle(0.0f, 0.9f, -4.0f);
+        emitRunDust(0.0f, 0.0f);
+        updateParticles(0.15f);
+    }
+    b.itemsPerIteration = particles.count;
+    keep(particles.count);
+}
+BENCHMARK("particles_churn", benchParticleChurn);
@@ -0,0 +1,86 @@
+#include "bench.h"
+#include "../game.h"
+#include "../snapshot.h"
+
+/* ========================================================================
+   SNAPSHOT / REWIND BENCHMARKS
+   ========================================================================
+   State after ten seconds of play with the rewind ring full, so the
+   numbers are the per-tick cost of recording and the cost of a restore.
+   ======================================================================== */
+
+static void playTenSeconds() {
+    highScoreFile = nullptr;
+    resetGame();
+    for (int i = 0; i < rewindCapacity; i++) {
+        tickGame();
+        if (mode == GAMEOVER)
+            mode = PLAYING;
+        recordRewind();
+    }
+}
+
+static void benchSnapshotSave(Bench& b) {
+    std::vector<uint8_t> buf;
+    playTenSeconds();
+    b.resetTimer();
+    for (long i = 0; i < b.iterations; i++)
+        saveSnapshot(buf);
+    keep(buf.size());
+}
+BENCHMARK("snapshot_save", benchSnapshotSave);
+
+static void benchSnapshotLoad(Bench& b) {
+    std::vector<uint8_t> buf;
+    playTenSeconds();
+    saveSnapshot(buf);
+    b.resetTimer();
+    for (long i = 0; i < b.iterations; i++)
+        loadSnapshot(buf.data(), buf.size());
+    keep(distanceScore);
+}
+BENCHMARK("snapshot_load", benchSnapshotLoad);
+
+static void benchRewindRecord(Bench& b) {
+    playTenSeconds();
+    b.resetTimer();
+    for (long i = 0; i < b.iterations; i++)
+        recordRewind();
+    keep(rewindBytes());
+}
+BENCHMARK("rewind_record", benchRewindRecord);
+
+/* Half a second back; the ticks given up are replayed untimed so the
+   ring never runs dry. */
+static void benchRewindRestore(Bench& b) {
+    playTenSeconds();
+    b.resetTimer();
+    for (long i = 0; i < b.iterations; i++) {
+        rewindTicks(30);
+        b.pauseTimer();
+        for (int k = 0; k < 30; k++) {
+            tickGame();
+            if (mode == GAMEOVER)
+                mode = PLAYING;
+            recordRewind();
+        }
+        b.resumeTimer();
+    }
+    keep(distanceScore);
+}
+BENCHMARK("rewind_restore", benchRewindRestore);
+
+static void benchRewindRecordStress(Bench& b) {
+    setLaneCount(64);
+    carDensity = 60;
+    playTenSeconds();
+    b.resetTimer();
+    for (long i = 0; i < b.iterations; i++)
+        recordRewind();
+    keep(rewindBytes());
+
+    setLaneCount(3);
+    carDensity = 15;
+    resetGame();
+}
+BENCHMARK("rewind_record_64lanes", benchRewindRecordStress);
@@ -0,0 +1,154 @@
+#include "bench.h"
+#include "../game.h"
+#include "../scene.h"
+#include "../particles.h"
+#include "../soft_renderer.h"
+
+/* ========================================================================
+   SOFTWARE RENDERER BENCHMARKS
+   ========================================================================
+   Full frames (sky, world, robot) at 1920x1080 after a few seconds of
+   play; items_per_sec is frames per second for the given thread count.
+   ======================================================================== */
+
+template <int THREADS>
+static void benchSoftFrame(Bench& b) {
+
+    highScoreFile = nullptr;
+    resetGame();
+    currentLane = laneCount / 2;
+    for (int i = 0; i < 300 && mode == PLAYING; i++)
+        tickGame();
+    mode = PLAYING;
+
+    SoftRenderer r(1920, 1080, THREADS);
+    setSceneProjection(r);
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++) {
+        r.clear();
+        drawScene(r);
+        r.finish();
+    }
+    keep(r.pixels()[1920 * 540 + 960]);
+}
+BENCHMARK("softraster_1080p_t1", benchSoftFrame<1>);
+BENCHMARK("softraster_1080p_t2", benchSoftFrame<2>);
+BENCHMARK("softraster_1080p_t4", benchSoftFrame<4>);
+BENCHMARK("softraster_1080p_t8", benchSoftFrame<8>);
+
+/* ========================================================================
+   IDLE SCREENS
+   ========================================================================
+   One 60 Hz tick of the window's loop in a given mode at 1080p on one
+   thread: tickGame(), then a frame only if sceneStamp() moved ("idle")
+   or unconditionally as the window used to ("always"). ns_per_op * 3600
+   is the CPU time per minute spent in that mode once the dust and
+   debris left over from play have settled (a second or so).
+   ======================================================================== */
+
+template <GameMode MODE, bool ALWAYS>
+static void benchFrameLoop(Bench& b) {
+
+    highScoreFile = nullptr;
+    resetGame();
+    currentLane = laneCount / 2;
+    for (int i = 0; i < 300 && mode == PLAYING; i++)
+        tickGame();
+    mode = MODE;
+    while (particles.count > 0 && MODE != PAUSED)
+        tickGame();
+
+    SoftRenderer r(1920, 1080, 1);
+    setSceneProjection(r);
+    uint64_t shown = 0;
+    bool valid = false;
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++) {
+        tickGame();
+        uint64_t stamp = sceneStamp();
+        if (ALWAYS || !valid || stamp != shown) {
+            r.clear();
+            drawScene(r);
+            r.finish();
+            shown = stamp;
+            valid = true;
+        }
+    }
+    keep(r.pixels()[1920 * 540 + 960]);
+}
+BENCHMARK("frame_loop_menu_always", (benchFrameLoop<MENU, true>));
+BENCHMARK("frame_loop_menu_idle", (benchFrameLoop<MENU, false>));
+BENCHMARK("frame_loop_paused_always", (benchFrameLoop<PAUSED, true>));
+BENCHMARK("frame_loop_paused_idle", (benchFrameLoop<PAUSED, false>));
+BENCHMARK("frame_loop_gameover_always", (benchFrameLoop<GAMEOVER, true>));
+BENCHMARK("frame_loop_gameover_idle", (benchFrameLoop<GAMEOVER, false>));
+
+/* ========================================================================
+   SPLIT SCREEN
+   ========================================================================
+   Four players at 1080p on four threads. "shared" is drawSplitScene(),
+   which builds the world view once per frame; "rebuilt" runs the
+   single-player drawScene() path in each viewport, so the scenery
+   walk, culling and matrix batches are redone four times.
+   world_view_build is that per-frame work on its own.
+   ======================================================================== */
+
+static void startSplitGame() {
+    highScoreFile = nullptr;
+    setPlayerCount(4);
+    setLaneCount(5);
+    resetGame();
+    for (int i = 0; i < 300 && mode == PLAYING; i++)
+        tickGame();
+    mode = PLAYING;
+}
+
+static void endSplitGame() {
+    setPlayerCount(1);
+    setLaneCount(3);
+    resetGame();
+}
+
+template <bool SHARED>
+static void benchSplitScreen(Bench& b) {
+
+    startSplitGame();
+
+    SoftRenderer r(1920, 1080, 4);
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++) {
+        r.clear();
+        if (SHARED)
+            drawSplitScene(r, playerCount, 1920, 1080);
+        else
+            for (int p = 0; p < playerCount; p++) {
+                Viewport vp = splitScreenViewport(p, playerCount, 1920, 1080);
+                r.setViewport(vp.x, vp.y, vp.w, vp.h);
+                setSceneProjection(r);
+                drawScene(r);
+            }
+        r.finish();
+    }
+    keep(r.pixels()[1920 * 540 + 960]);
+
+    endSplitGame();
+}
+BENCHMARK("split_screen_4p_shared", benchSplitScreen<true>);
+BENCHMARK("split_screen_4p_rebuilt", benchSplitScreen<false>);
+
+static void benchWorldViewBuild(Bench& b) {
+
+    startSplitGame();
+
+    WorldView view;
+    b.resetTimer();
+    for (long i = 0; i < b.iterations; i++)
+        buildWorldView(view);
+    keep(view.groundXyz.size());
+
+    endSplitGame();
+}
+BENCHMARK("world_view_build", benchWorldViewBuild);
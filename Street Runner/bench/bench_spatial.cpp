@@ -0,0 +1,108 @@
+#include "bench.h"
+#include "../game.h"
+#include "../traffic.h"
+#include "../spatial.h"
+
+/* ========================================================================
+   SPATIAL INDEX BENCHMARKS
+   ========================================================================
+   64 lanes at 60% traffic: several thousand cars and coins on the road.
+   Queries are spread over the whole road; items_per_sec is queries per
+   second. The _linear variant answers the same magnet query by scanning
+   every coin and car, which is what a query costs without the index.
+   ======================================================================== */
+
+static void crowdRoad() {
+    setLaneCount(64);
+    carDensity = 60;
+    highScoreFile = nullptr;
+    resetGame();
+}
+
+static void restoreRoad() {
+    setLaneCount(3);
+    carDensity = 15;
+    resetGame();
+}
+
+/* Query centre number i: some lane, some distance down the road. */
+static inline float queryX(long i) { return laneX((int)(i * 37 % laneCount)); }
+static inline float queryZ(long i) { return -(float)(i * 53 % 150); }
+
+static void benchSpatialBuild(Bench& b) {
+
+    crowdRoad();
+    b.itemsPerIteration = traffic.count + coins.size() + powerUps.size();
+    ItemHit hit;
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++) {
+        markItemsMoved(ITEM_ALL);
+        keep(queryItemsInBox(0, 0, 0, 0, ITEM_ALL, &hit, 1));
+    }
+
+    restoreRoad();
+}
+BENCHMARK("spatial_build_64lanes", benchSpatialBuild);
+
+static void benchSpatialRadius(Bench& b) {
+
+    crowdRoad();
+    ItemHit hits[64];
+    long found = 0;
+    queryItemsInRadius(0, 0, 1, ITEM_COIN, hits, 64);
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++)
+        found += queryItemsInRadius(queryX(i), queryZ(i), magnetRadius,
+                                    ITEM_COIN | ITEM_CAR, hits, 64);
+    keep(found);
+
+    restoreRoad();
+}
+BENCHMARK("spatial_radius_64lanes", benchSpatialRadius);
+
+static void benchSpatialBox(Bench& b) {
+
+    crowdRoad();
+    ItemHit hits[64];
+    long found = 0;
+    queryItemsInBox(0, 0, 0, 0, ITEM_COIN, hits, 64);
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++) {
+        float x = queryX(i), z = queryZ(i);
+        found += queryItemsInBox(x - laneWidth * 0.5f, z - 0.8f,
+                                 x + laneWidth * 0.5f, z + 0.8f,
+                                 ITEM_COIN | ITEM_POWERUP | ITEM_CAR,
+                                 hits, 64);
+    }
+    keep(found);
+
+    restoreRoad();
+}
+BENCHMARK("spatial_box_64lanes", benchSpatialBox);
+
+static void benchSpatialLinear(Bench& b) {
+
+    crowdRoad();
+    const float r2 = magnetRadius * magnetRadius;
+    long found = 0;
+    b.resetTimer();
+
+    for (long i = 0; i < b.iterations; i++) {
+        float x = queryX(i), z = queryZ(i);
+        for (const Coin& c : coins) {
+            float dx = laneX(c.lane) - x, dz = segmentZ(c.seg) - z;
+            found += !c.collected && dx * dx + dz * dz <= r2;
+        }
+        for (int k = 0; k < traffic.count; k++) {
+            float dx = traffic.x[k] - x, dz = traffic.z[k] - z;
+            found += dx * dx + dz * dz <= r2;
+        }
+    }
+    keep(found);
+
+    restoreRoad();
+}
+BENCHMARK("spatial_radius_linear_64lanes", benchSpatialLinear);
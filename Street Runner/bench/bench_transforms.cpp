@@ -0,0 +1,84 @@
+#include "bench.h"
+#include "../math3d.h"
+#include "../soft_renderer.h"
+
+#include <vector>
+
+/* ========================================================================
+   TRANSFORM BENCHMARKS
+   ========================================================================
+   Model matrices for 4096 trees (translate, then stand the cone up),
+   items_per_sec being matrices per second. "stack" is what drawTree()
+   did per object: push, translate, rotate, pop on the renderer's matrix
+   stack (the software renderer's; a GL driver's stack is not available
+   headless). "batch" is what drawTrees() does now: one shared local
+   matrix, one pass over the positions.
+   ======================================================================== */
+
+static const int transformCount = 4096;
+
+static void treePositions(std::vector<float>& x, std::vector<float>& z) {
+    x.resize(transformCount);
+    z.resize(transformCount);
+    for (int i = 0; i < transformCount; i++) {
+        x[i] = (i & 1 ? 1.0f : -1.0f) * (6.0f + (i % 7));
+        z[i] = -0.05f * i;
+    }
+}
+
+static void benchTransformStack(Bench& b) {
+
+    std::vector<float> x, z;
+    treePositions(x, z);
+    SoftRenderer r(64, 64, 1);
+
+    b.itemsPerIteration = transformCount;
+    b.resetTimer();
+    for (long it = 0; it < b.iterations; it++)
+        for (int i = 0; i < transformCount; i++) {
+            r.pushMatrix();
+            r.translate(x[i], 0.0f, z[i]);
+            r.rotate(-90.0f, 1.0f, 0.0f, 0.0f);
+            r.popMatrix();
+        }
+    keep(r.pixels()[0]);
+}
+BENCHMARK("transform_stack_4096", benchTransformStack);
+
+static void benchTransformBatch(Bench& b) {
+
+    std::vector<float> x, z;
+    std::vector<Mat4> out(transformCount);
+    treePositions(x, z);
+    const Mat4 upright = mat4Rotation(-90.0f, 1.0f, 0.0f, 0.0f);
+
+    b.itemsPerIteration = transformCount;
+    b.resetTimer();
+    for (long it = 0; it < b.iterations; it++)
+        mat4TranslateBatch(upright, x.data(), 0.0f, z.data(),
+                           transformCount, out.data());
+    keep(out[transformCount / 2].m[14]);
+}
+BENCHMARK("transform_batch_4096", benchTransformBatch);
+
+/* The software backend's per-instance cost on top of the batch:
+   view * model for every matrix. */
+static void benchTransformMultiply(Bench& b) {
+
+    std::vector<float> x, z;
+    std::vector<Mat4> models(transformCount), out(transformCount);
+    treePositions(x, z);
+    mat4TranslateBatch(mat4Rotation(-90.0f, 1.0f, 0.0f, 0.0f),
+                       x.data(), 0.0f, z.data(), transformCount,
+                       models.data());
+    const Mat4 view = mat4Multiply(mat4Rotation(10.0f, 1.0f, 0.0f, 0.0f),
+                                   mat4Translation(0.0f, -3.0f, -6.0f));
+
+    b.itemsPerIteration = transformCount;
+    b.resetTimer();
+    for (long it = 0; it < b.iterations; it++)
+        for (int i = 0; i < transformCount; i++)
+            out[i] = mat4Multiply(view, models[i]);
+    keep(out[transformCount / 2].m[14]);
+}
+BENCHMARK("transform_multiply_4096", benchTransformMultiply);
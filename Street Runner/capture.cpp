@@ -0,0 +1,329 @@
+#include "capture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+inline double secondsSince(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t).count();
+}
+
+/* Top-down row y of a frame stored either way up. */
+inline const uint8_t* sourceRow(const uint8_t* rgba, int width, int height,
+                                bool bottomUp, int y) {
+    int row = bottomUp ? height - 1 - y : y;
+    return rgba + (size_t)row * width * 4;
+}
+
+/* ========================================================================
+   PNG
+   ======================================================================== */
+
+uint32_t crcTable[256];
+
+void buildCrcTable() {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++)
+            c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        crcTable[n] = c;
+    }
+}
+
+uint32_t crc32(const uint8_t* p, size_t n) {
+    static bool built = (buildCrcTable(), true);
+    (void)built;
+    uint32_t c = 0xffffffffu;
+    for (size_t i = 0; i < n; i++)
+        c = crcTable[(c ^ p[i]) & 0xff] ^ (c >> 8);
+    return c ^ 0xffffffffu;
+}
+
+uint32_t adler32(const uint8_t* p, size_t n) {
+    uint32_t a = 1, b = 0;
+    while (n) {
+        size_t run = std::min<size_t>(n, 5552);   /* no overflow before % */
+        n -= run;
+        while (run--) {
+            a += *p++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+inline void putBE32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back((uint8_t)(v >> 24));
+    out.push_back((uint8_t)(v >> 16));
+    out.push_back((uint8_t)(v >> 8));
+    out.push_back((uint8_t)v);
+}
+
+void putChunk(std::vector<uint8_t>& out, const char* type,
+              const uint8_t* data, size_t n) {
+    putBE32(out, (uint32_t)n);
+    size_t at = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + n);
+    putBE32(out, crc32(&out[at], n + 4));
+}
+
+}
+
+bool parseCaptureFormat(const char* s, CaptureFormat& out) {
+    if      (!std::strcmp(s, "raw")) out = CAPTURE_RAW;
+    else if (!std::strcmp(s, "y4m")) out = CAPTURE_Y4M;
+    else if (!std::strcmp(s, "png")) out = CAPTURE_PNG;
+    else return false;
+    return true;
+}
+
+void rgbaToYuv420(const uint8_t* rgba, int width, int height, bool bottomUp,
+                  std::vector<uint8_t>& out) {
+
+    const int cw = (width + 1) / 2, ch = (height + 1) / 2;
+    out.resize((size_t)width * height + 2 * (size_t)cw * ch);
+    uint8_t* yp = out.data();
+    uint8_t* up = yp + (size_t)width * height;
+    uint8_t* vp = up + (size_t)cw * ch;
+
+    /* Full-range BT.601 in 8.8 fixed point. */
+    for (int y = 0; y < height; y++) {
+        const uint8_t* s = sourceRow(rgba, width, height, bottomUp, y);
+        uint8_t* d = yp + (size_t)y * width;
+        for (int x = 0; x < width; x++, s += 4)
+            d[x] = (uint8_t)((77 * s[0] + 150 * s[1] + 29 * s[2] + 128) >> 8);
+    }
+
+    /* Chroma from the average of each 2x2 block, edges clamped. */
+    for (int y = 0; y < ch; y++) {
+        const uint8_t* s0 = sourceRow(rgba, width, height, bottomUp, 2 * y);
+        const uint8_t* s1 = sourceRow(rgba, width, height, bottomUp,
+                                      std::min(2 * y + 1, height - 1));
+        for (int x = 0; x < cw; x++) {
+            int x0 = 2 * x * 4, x1 = std::min(2 * x + 1, width - 1) * 4;
+            int r = s0[x0] + s0[x1] + s1[x0] + s1[x1];
+            int g = s0[x0 + 1] + s0[x1 + 1] + s1[x0 + 1] + s1[x1 + 1];
+            int b = s0[x0 + 2] + s0[x1 + 2] + s1[x0 + 2] + s1[x1 + 2];
+            int u = (-43 * r - 85 * g + 128 * b + 4 * 32896) >> 10;
+            int v = (128 * r - 107 * g - 21 * b + 4 * 32896) >> 10;
+            up[(size_t)y * cw + x] = (uint8_t)std::min(u, 255);
+            vp[(size_t)y * cw + x] = (uint8_t)std::min(v, 255);
+        }
+    }
+}
+
+void encodePNG(const uint8_t* rgba, int width, int height, bool bottomUp,
+               std::vector<uint8_t>& out) {
+
+    static const uint8_t signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+    /* Scanlines: filter type 0, then RGB. */
+    const size_t stride = 1 + (size_t)width * 3;
+    std::vector<uint8_t> raw(stride * height);
+    for (int y = 0; y < height; y++) {
+        const uint8_t* s = sourceRow(rgba, width, height, bottomUp, y);
+        uint8_t* d = &raw[stride * y];
+        *d++ = 0;
+        for (int x = 0; x < width; x++, s += 4, d += 3) {
+            d[0] = s[0];
+            d[1] = s[1];
+            d[2] = s[2];
+        }
+    }
+
+    /* zlib stream of stored deflate blocks. */
+    std::vector<uint8_t> z;
+    z.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    z.push_back(0x78);
+    z.push_back(0x01);
+    for (size_t at = 0; ; ) {
+        size_t n = std::min<size_t>(raw.size() - at, 65535);
+        bool last = at + n == raw.size();
+        z.push_back(last ? 1 : 0);
+        z.push_back((uint8_t)n);
+        z.push_back((uint8_t)(n >> 8));
+        z.push_back((uint8_t)~n);
+        z.push_back((uint8_t)(~n >> 8));
+        z.insert(z.end(), raw.begin() + at, raw.begin() + at + n);
+        at += n;
+        if (last)
+            break;
+    }
+    putBE32(z, adler32(raw.data(), raw.size()));
+
+    std::vector<uint8_t> ihdr;
+    putBE32(ihdr, (uint32_t)width);
+    putBE32(ihdr, (uint32_t)height);
+    const uint8_t rest[5] = { 8, 2, 0, 0, 0 };   /* 8-bit RGB */
+    ihdr.insert(ihdr.end(), rest, rest + 5);
+
+    out.assign(signature, signature + 8);
+    putChunk(out, "IHDR", ihdr.data(), ihdr.size());
+    putChunk(out, "IDAT", z.data(), z.size());
+    putChunk(out, "IEND", nullptr, 0);
+}
+
+/* ========================================================================
+   ENCODER
+   ======================================================================== */
+
+FrameEncoder::FrameEncoder(CaptureFormat format, const std::string& path,
+                           int width, int height, int slotCount)
+    : format(format), path(path), frameWidth(width), frameHeight(height),
+      file(nullptr), failed(false),
+      slots(std::max(slotCount, 1)),
+      head(0), queued(0), stopping(false), counters() {
+
+    for (Slot& s : slots)
+        s.rgba.resize((size_t)width * height * 4);
+
+    if (format != CAPTURE_PNG) {
+        file = std::fopen(path.c_str(), "wb");
+        if (!file)
+            failed = true;
+        else if (format == CAPTURE_Y4M)
+            std::fprintf(file, "YUV4MPEG2 W%d H%d F60:1 Ip A1:1 "
+                         "C420jpeg XYSCSS=420JPEG XCOLORRANGE=FULL\n",
+                         width, height);
+    }
+
+    encoder = std::thread(&FrameEncoder::encoderLoop, this);
+}
+
+FrameEncoder::~FrameEncoder() {
+    finish();
+}
+
+void FrameEncoder::finish() {
+
+    {
+        std::lock_guard<std::mutex> g(lock);
+        stopping = true;
+    }
+    ready.notify_one();
+    if (encoder.joinable())
+        encoder.join();
+
+    if (file) {
+        if (std::fclose(file) != 0)
+            failed = true;
+        file = nullptr;
+    }
+}
+
+bool FrameEncoder::submit(const uint8_t* rgba, bool bottomUp, bool wait) {
+
+    auto start = std::chrono::steady_clock::now();
+    const int n = (int)slots.size();
+
+    {
+        std::unique_lock<std::mutex> g(lock);
+        counters.submitted++;
+        if (wait)
+            slotFreed.wait(g, [&] { return queued < n || stopping; });
+        if (queued == n || failed || stopping) {
+            counters.dropped++;
+            counters.submitSeconds += secondsSince(start);
+            return false;
+        }
+    }
+
+    /* slots[head] is not queued, so the encoder does not touch it. */
+    Slot& s = slots[head];
+    std::memcpy(s.rgba.data(), rgba, s.rgba.size());
+    s.bottomUp = bottomUp;
+
+    {
+        std::lock_guard<std::mutex> g(lock);
+        head = (head + 1) % n;
+        queued++;
+        counters.submitSeconds += secondsSince(start);
+    }
+    ready.notify_one();
+    return true;
+}
+
+CaptureStats FrameEncoder::stats() {
+    std::lock_guard<std::mutex> g(lock);
+    return counters;
+}
+
+void FrameEncoder::encoderLoop() {
+
+    const int n = (int)slots.size();
+    long index = 0;
+
+    for (;;) {
+        int tail;
+        {
+            std::unique_lock<std::mutex> g(lock);
+            ready.wait(g, [this] { return queued > 0 || stopping; });
+            if (queued == 0)
+                return;
+            tail = (head - queued + n) % n;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = writeFrame(slots[tail], index++);
+
+        std::lock_guard<std::mutex> g(lock);
+        queued--;
+        slotFreed.notify_one();
+        counters.encodeSeconds += secondsSince(start);
+        if (ok)
+            counters.written++;
+        else {
+            counters.dropped++;
+            failed = true;
+        }
+    }
+}
+
+bool FrameEncoder::writeFrame(const Slot& s, long index) {
+
+    const int w = frameWidth, h = frameHeight;
+
+    switch (format) {
+
+        case CAPTURE_RAW:
+            scratch.resize((size_t)w * h * 3);
+            for (int y = 0; y < h; y++) {
+                const uint8_t* src = sourceRow(s.rgba.data(), w, h,
+                                               s.bottomUp, y);
+                uint8_t* d = &scratch[(size_t)y * w * 3];
+                for (int x = 0; x < w; x++, src += 4, d += 3) {
+                    d[0] = src[0];
+                    d[1] = src[1];
+                    d[2] = src[2];
+                }
+            }
+            return file &&
+                   std::fwrite(scratch.data(), 1, scratch.size(), file) ==
+                   scratch.size();
+
+        case CAPTURE_Y4M:
+            rgbaToYuv420(s.rgba.data(), w, h, s.bottomUp, scratch);
+            return file && std::fputs("FRAME\n", file) >= 0 &&
+                   std::fwrite(scratch.data(), 1, scratch.size(), file) ==
+                   scratch.size();
+
+        case CAPTURE_PNG: {
+            encodePNG(s.rgba.data(), w, h, s.bottomUp, scratch);
+            char name[32];
+            std::snprintf(name, sizeof(name), "_%05ld.png", index);
+            FILE* f = std::fopen((path + name).c_str(), "wb");
+            if (!f)
+                return false;
+            bool ok = std::fwrite(scratch.data(), 1, scratch.size(), f) ==
+                      scratch.size();
+            return std::fclose(f) == 0 && ok;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,111 @@
+#ifndef STREET_RUNNER_CAPTURE_H
+#define STREET_RUNNER_CAPTURE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* ========================================================================
+   FRAME CAPTURE
+   ========================================================================
+   FrameEncoder takes RGBA8 frames from the render thread and writes them
+   on a thread of its own. submit() only copies the frame into a free
+   slot of a small ring; when every slot is still waiting for the
+   encoder the frame is dropped and counted rather than blocking the
+   game. Rows may come bottom-up (glReadPixels order); the encoder flips
+   them.
+
+   Formats:
+     raw  RGB24 frames back to back, top row first, in one file
+          (ffmpeg -f rawvideo -pix_fmt rgb24 -s WxH -r 60)
+     y4m  YUV4MPEG2, 4:2:0, full-range BT.601, 60 fps, in one file
+     png  one PNG per frame, path_00000.png ...; stored (uncompressed)
+          deflate so there is no zlib dependency
+   ======================================================================== */
+
+enum CaptureFormat { CAPTURE_RAW, CAPTURE_Y4M, CAPTURE_PNG };
+
+/* "raw", "y4m" or "png"; false for anything else. */
+bool parseCaptureFormat(const char* s, CaptureFormat& out);
+
+struct CaptureStats {
+    long submitted;         /* frames offered to submit() */
+    long written;
+    long dropped;           /* no free slot, or a write failed */
+    double submitSeconds;   /* time spent inside submit() */
+    double encodeSeconds;   /* encoder thread time, conversion + I/O */
+};
+
+class FrameEncoder {
+public:
+    /* path is the output file for raw and y4m, the file name prefix
+       for png. slots is how many frames may wait for the encoder. */
+    FrameEncoder(CaptureFormat format, const std::string& path,
+                 int width, int height, int slots = 4);
+
+    /* Writes out everything still queued. */
+    ~FrameEncoder();
+
+    FrameEncoder(const FrameEncoder&) = delete;
+    FrameEncoder& operator=(const FrameEncoder&) = delete;
+
+    bool ok() const { return !failed; }
+    int width() const { return frameWidth; }
+    int height() const { return frameHeight; }
+
+    /* Queues a width() x height() RGBA8 frame. Returns false if it was
+       dropped. With wait set, a full ring blocks until the encoder
+       frees a slot instead (offline rendering). */
+    bool submit(const uint8_t* rgba, bool bottomUp, bool wait = false);
+
+    /* Writes out everything still queued and stops the encoder thread;
+       later frames are dropped. */
+    void finish();
+
+    CaptureStats stats();
+
+private:
+    struct Slot {
+        std::vector<uint8_t> rgba;
+        bool bottomUp;
+    };
+
+    void encoderLoop();
+    bool writeFrame(const Slot& s, long index);
+
+    CaptureFormat format;
+    std::string path;
+    int frameWidth, frameHeight;
+    FILE* file;
+    std::atomic<bool> failed;
+
+    std::vector<Slot> slots;
+    std::vector<uint8_t> scratch;
+
+    std::mutex lock;
+    std::condition_variable ready;
+    std::condition_variable slotFreed;
+    int head;               /* next slot to fill */
+    int queued;             /* slots waiting for the encoder */
+    bool stopping;
+    CaptureStats counters;
+
+    std::thread encoder;
+};
+
+/* Conversions behind the writers, exposed for the benchmarks. */
+
+/* Planar Y, then U and V at half resolution (rounded up). */
+void rgbaToYuv420(const uint8_t* rgba, int width, int height, bool bottomUp,
+                  std::vector<uint8_t>& out);
+
+/* A complete PNG file (RGB, 8 bits per channel) in memory. */
+void encodePNG(const uint8_t* rgba, int width, int height, bool bottomUp,
+               std::vector<uint8_t>& out);
+
+#endif
@@ -0,0 +1,514 @@
+#include "game.h"
+#include "particles.h"
+#include "traffic.h"
+#include "snapshot.h"
+#include "spatial.h"
+#include "reachability.h"
+
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+/* ========================================================================
+   SECTION 1: GLOBAL SETTINGS & VARIABLES
+   ======================================================================== */
+
+GameMode mode = MENU;
+
+long distanceScore = 0;
+long coinScore = 0;
+long highScore = 0;
+
+const char* highScoreFile = "highscore.txt";
+
+long currentSegment = 0;
+float roadOffset = 0.0f;
+
+float scrollSpeed = 0.15f;
+float baseScrollSpeed = 0.15f;
+float maxScrollSpeed  = 0.45f;
+float difficultyFactor = 0.0000025f;
+
+float playerX = 0.0f;
+float playerY = 0.5f;
+int currentLane = 0;
+float targetX = 0.0f;
+
+int laneCount = 3;
+float roadHalfWidth = 3.3f;
+float laneSpeed = 0.3f;
+
+int carDensity = 15;
+long movedCars = 0;
+long droppedCars = 0;
+
+bool isJumping = false;
+float velY = 0.0f;
+
+float windmillAngle = 0.0f;
+float countdownValue = 3.0f;
+
+float dayCycle = 0.0f;
+
+std::vector<Coin> coins;
+std::vector<PowerUp> powerUps;
+
+float magnetTime = 0.0f;
+float shieldTime = 0.0f;
+float slowMotionTime = 0.0f;
+
+Runner runners[maxPlayers];
+int playerCount = 1;
+int activePlayer = 0;
+
+/* ========================================================================
+   HIGH SCORE SYSTEM
+   ======================================================================== */
+
+void loadHighScore() {
+    if (!highScoreFile) return;
+    FILE* f = fopen(highScoreFile, "r");
+    if (f) { fscanf(f, "%ld", &highScore); fclose(f); }
+}
+
+void saveHighScore() {
+    if (distanceScore > highScore) {
+        highScore = distanceScore;
+        if (!highScoreFile) return;
+        FILE* f = fopen(highScoreFile, "w");
+        if (f) { fprintf(f, "%ld", highScore); fclose(f); }
+    }
+}
+
+/* ========================================================================
+   WORLD GENERATION
+   ======================================================================== */
+
+/* The speed difficultyFactor per tick would have ramped up to by the
+   time the road got this far: v^2 = v0^2 + 2 a d. */
+float scrollSpeedAt(double distance) {
+    double v0 = baseScrollSpeed;
+    return (float)std::min((double)maxScrollSpeed,
+                           std::sqrt(v0 * v0 +
+                                     2.0 * difficultyFactor * distance));
+}
+
+void setLaneCount(int lanes) {
+    laneCount = std::min(std::max(lanes, 1), maxLanes);
+    roadHalfWidth = laneCount * laneWidth * 0.5f + 0.3f;
+}
+
+void setPlayerCount(int players) {
+    playerCount = std::min(std::max(players, 1), maxPlayers);
+}
+
+static void loadPlayer(int p) {
+
+    const Runner& s = runners[p];
+    playerX = s.x;
+    playerY = s.y;
+    targetX = s.targetX;
+    velY = s.velY;
+    currentLane = s.lane;
+    isJumping = s.jumping;
+    coinScore = s.coins;
+    magnetTime = s.magnet;
+    shieldTime = s.shield;
+    activePlayer = p;
+}
+
+static void storePlayer(Runner& s) {
+    s.x = playerX;
+    s.y = playerY;
+    s.targetX = targetX;
+    s.velY = velY;
+    s.lane = currentLane;
+    s.jumping = isJumping;
+    s.coins = coinScore;
+    s.magnet = magnetTime;
+    s.shield = shieldTime;
+}
+
+void selectPlayer(int p) {
+    storePlayer(runners[activePlayer]);
+    loadPlayer(p);
+}
+
+Runner playerState(int p) {
+    Runner s = runners[p];
+    if (p == activePlayer)
+        storePlayer(s);
+    return s;
+}
+
+void steerPlayer(int p, int dir) {
+
+    if (runners[p].out)
+        return;
+
+    int active = activePlayer;
+    selectPlayer(p);
+    currentLane = std::min(std::max(currentLane + dir, 0), laneCount - 1);
+    selectPlayer(active);
+}
+
+void jumpPlayer(int p) {
+
+    if (runners[p].out)
+        return;
+
+    int active = activePlayer;
+    selectPlayer(p);
+    if (!isJumping) {
+        isJumping = true;
+        velY = JUMP_FORCE;
+    }
+    selectPlayer(active);
+}
+
+void spawn(long seg) {
+
+    uint32_t h = hash32((uint32_t)seg ^ 0xA53C9E11U);
+    int safeLane = (int)(h % laneCount);
+    bool hasCar[maxLanes];
+    uint32_t seeds[maxLanes];
+
+    for (int lane = 0; lane < laneCount; lane++) {
+        hasCar[lane] = lane != safeLane &&
+            (int)(hash32(h ^ (lane + 6) * 123u) % 100) < carDensity;
+        seeds[lane] = hash32(h ^ (lane + 6) * 321u);
+    }
+    placeCars(seg, hasCar, seeds);
+
+    bool hasCoin[maxLanes];
+
+    for (int lane = 0; lane < laneCount; lane++) {
+        hasCoin[lane] = !hasCar[lane] &&
+            (int)(hash32(h ^ (lane + 8) * 999u) % 100) < 30;
+        if (hasCoin[lane])
+            coins.push_back({ seg, lane, false });
+    }
+
+    /* About one segment in 25 carries a power-up. */
+    uint32_t p = hash32(h ^ 0x5bd1e995U);
+    int lane = (int)((p >> 8) % laneCount);
+    if (p % 100 < 4 && !hasCar[lane] && !hasCoin[lane]) {
+        uint8_t kind = (uint8_t)((p >> 20) % powerUpKinds);
+        if (kind != POWERUP_SLOWMO || placeSlowMotion(seg))
+            powerUps.push_back({ seg, lane, kind, false });
+    }
+}
+
+void resetGame() {
+
+    mode = PLAYING;
+
+    distanceScore = 0;
+    coinScore = 0;
+    currentSegment = 0;
+    roadOffset = 0.0f;
+
+    /* One player starts in the middle lane; more spread out evenly. */
+    for (int p = 0; p < playerCount; p++) {
+        Runner& s = runners[p];
+        s.lane = playerCount == 1
+            ? laneCount / 2
+            : (2 * p + 1) * laneCount / (2 * playerCount);
+        s.x = s.targetX = laneX(s.lane);
+        s.y = 0.5f;
+        s.velY = 0.0f;
+        s.jumping = false;
+        s.out = false;
+        s.coins = 0;
+        s.magnet = s.shield = 0.0f;
+    }
+    loadPlayer(0);
+
+    windmillAngle = 0.0f;
+
+    slowMotionTime = 0.0f;
+
+    clearTraffic();
+    coins.clear();
+    powerUps.clear();
+    clearParticles();
+    clearRewind();
+    resetReachability();
+
+    /* Up to the segment the first crossing spawns. */
+    for (long s = 5; s <= visibleSegments + 40; s++)
+        spawn(s);
+    markItemsMoved(ITEM_ALL);
+}
+
+/* ========================================================================
+   SCENERY CACHE
+   ======================================================================== */
+
+SegmentScenery sceneryRing[sceneryRingSize];
+
+static inline void addScenery(SegmentScenery& s,
+                              SceneryType type, int side, float offset) {
+    s.items[s.count++] = { (uint8_t)type, (int8_t)side, offset };
+}
+
+void buildScenery(long seg) {
+
+    SegmentScenery& s = sceneryRing[seg & (sceneryRingSize - 1)];
+    s.seg = seg;
+    s.built = true;
+    s.count = 0;
+
+    uint32_t h = hash32((uint32_t)seg ^ 0x9e3779b9U);
+
+    if ((h % 10) > 6)
+        addScenery(s, SCENERY_TREE, 1, 3.0f + (h % 5));
+
+    if (((h >> 4) % 10) > 7)
+        addScenery(s, SCENERY_TREE, -1, 3.0f + ((h >> 8) % 5));
+
+    if (seg % 25 == 0)
+        addScenery(s, SCENERY_WINDMILL, 1, 9.0f);
+
+    if (seg % 17 == 0)
+        addScenery(s, SCENERY_HOUSE, -1, 12.0f);
+
+    if (seg % 23 == 0)
+        addScenery(s, SCENERY_HOUSE, 1, 12.0f);
+
+    if (seg % 11 == 0)
+        addScenery(s, SCENERY_CHARACTER, -1, 6.0f);
+
+    if (seg % 13 == 0)
+        addScenery(s, SCENERY_CHARACTER, 1, 6.0f);
+}
+
+const SegmentScenery& sceneryFor(long seg) {
+    const SegmentScenery& s = sceneryRing[seg & (sceneryRingSize - 1)];
+    if (!s.built || s.seg != seg)
+        buildScenery(seg);
+    return s;
+}
+
+/* ========================================================================
+   UPDATE LOOP (DIFFICULTY + COLLISION FIX + DAY CYCLE)
+   ======================================================================== */
+
+static void collectCoin(int i) {
+    Coin& cn = coins[i];
+    cn.collected = true;
+    coinScore++;
+    emitCoinSparkle(laneX(cn.lane), 0.9f, segmentZ(cn.seg) + roadOffset);
+}
+
+static void collectPowerUp(int i) {
+
+    PowerUp& pu = powerUps[i];
+    pu.collected = true;
+    emitCoinSparkle(laneX(pu.lane), 1.0f, segmentZ(pu.seg) + roadOffset);
+
+    switch (pu.kind) {
+        case POWERUP_MAGNET: magnetTime = magnetDuration;         break;
+        case POWERUP_SHIELD: shieldTime = shieldDuration;         break;
+        case POWERUP_SLOWMO: slowMotionTime = slowMotionDuration; break;
+    }
+}
+
+/* The shield throws the cars the runner hits off the road. Removal
+   moves the last car into the freed index, so go from the highest. */
+static void smashCars(float x, float z) {
+
+    ItemHit hits[16];
+    int n = queryItemsInBox(x - laneWidth * 0.5f, z - carHitReach,
+                            x + laneWidth * 0.5f, z + carHitReach,
+                            ITEM_CAR, hits, 16);
+
+    std::sort(hits, hits + n,
+              [](const ItemHit& a, const ItemHit& b) {
+                  return a.index > b.index;
+              });
+
+    for (int k = 0; k < n; k++) {
+        emitCrashDebris(hits[k].x, 0.5f, hits[k].z + roadOffset);
+        removeCar(hits[k].index);
+    }
+    markItemsMoved(ITEM_CAR);
+}
+
+void checkCollisions() {
+
+    const float px = laneX(currentLane);
+    const float pz = -roadOffset;
+
+    bool hit = carsHittingPlayer() > 0 && playerY <= carRoofHeight;
+
+    if (hit && shieldTime > 0.0f) {
+        smashCars(px, pz);
+        hit = false;
+    }
+
+    if (hit) {
+        if (!runners[activePlayer].out)
+            emitCrashDebris(playerX, playerY, 0.0f);
+        runners[activePlayer].out = true;
+
+        bool allOut = true;
+        for (int p = 0; p < playerCount; p++)
+            allOut &= runners[p].out;
+        if (allOut) {
+            mode = GAMEOVER;
+            saveHighScore();
+        }
+    }
+
+    /* Pickups in the runner's lane, then everything the magnet
+       reaches. */
+    ItemHit hits[64];
+    int n = queryItemsInBox(px - laneWidth * 0.25f, pz - 0.8f,
+                            px + laneWidth * 0.25f, pz + 0.8f,
+                            ITEM_COIN | ITEM_POWERUP, hits, 64);
+
+    for (int k = 0; k < n; k++) {
+        if (hits[k].kind == ITEM_COIN && !coins[hits[k].index].collected)
+            collectCoin(hits[k].index);
+        if (hits[k].kind == ITEM_POWERUP &&
+            !powerUps[hits[k].index].collected)
+            collectPowerUp(hits[k].index);
+    }
+
+    if (magnetTime > 0.0f) {
+        n = queryItemsInRadius(playerX, pz, magnetRadius, ITEM_COIN,
+                               hits, 64);
+        for (int k = 0; k < n; k++)
+            if (!coins[hits[k].index].collected)
+                collectCoin(hits[k].index);
+    }
+}
+
+/* Jump, lane change and collisions for the active runner. */
+static void tickPlayer() {
+
+    magnetTime = std::max(0.0f, magnetTime - 1.0f);
+    shieldTime = std::max(0.0f, shieldTime - 1.0f);
+
+    if (isJumping) {
+        playerY += velY;
+        velY -= GRAVITY;
+        if (playerY <= 0.5f) {
+            playerY = 0.5f;
+            isJumping = false;
+            velY = 0.0f;
+        }
+    }
+
+    targetX = laneX(currentLane);
+
+    if (playerX < targetX)
+        playerX = std::min(targetX, playerX + laneSpeed);
+    else if (playerX > targetX)
+        playerX = std::max(targetX, playerX - laneSpeed);
+
+    if (!isJumping)
+        emitRunDust(playerX, 0.0f);
+
+    checkCollisions();
+}
+
+void tickGame() {
+
+    /* Slow motion scales everything the road carries along. */
+    const float timeScale = slowMotionTime > 0.0f ? slowMotionScale : 1.0f;
+
+    if (mode == COUNTDOWN) {
+        countdownValue -= 0.016f;
+        if (countdownValue <= 0)
+            mode = PLAYING;
+    }
+
+    if (mode == PLAYING) {
+
+        distanceScore++;
+        windmillAngle += 2.0f;
+
+        scrollSpeed = scrollSpeedAt(roadDistance());
+
+        laneSpeed = laneSpeedFor(scrollSpeed);
+
+        slowMotionTime = std::max(0.0f, slowMotionTime - 1.0f);
+
+        roadOffset += scrollSpeed * timeScale;
+        updateTraffic(timeScale);
+
+        if (roadOffset > segmentLength) {
+            roadOffset -= segmentLength;
+            currentSegment++;
+            rebaseTraffic(segmentLength);
+
+            /* Coins are appended in segment order; drop the ones
+               behind the camera. */
+            auto passed = std::find_if(coins.begin(), coins.end(),
+                [](const Coin& c) { return c.seg >= currentSegment - 1; });
+            coins.erase(coins.begin(), passed);
+
+            auto passedPowerUps =
+                std::find_if(powerUps.begin(), powerUps.end(),
+                    [](const PowerUp& p) {
+                        return p.seg >= currentSegment - 1;
+                    });
+            powerUps.erase(powerUps.begin(), passedPowerUps);
+
+            spawn(currentSegment + visibleSegments + 40);
+            buildScenery(currentSegment + visibleSegments - 1);
+            markItemsMoved(ITEM_COIN | ITEM_POWERUP);
+        }
+
+        markItemsMoved(ITEM_CAR);
+
+        dayCycle += 0.0005f;
+        if (dayCycle > 6.283f)
+            dayCycle = 0.0f;
+
+        for (int p = 0; p < playerCount; p++) {
+            if (runners[p].out)
+                continue;
+            selectPlayer(p);
+            tickPlayer();
+        }
+        selectPlayer(0);
+    }
+
+    if (mode != PAUSED)
+        updateParticles(mode == PLAYING ? scrollSpeed * timeScale : 0.0f);
+}
+
+uint64_t sceneStamp() {
+
+    uint64_t h = 0xcbf29ce484222325ULL;
+    auto mix = [&h](const void* p, size_t n) {
+        const unsigned char* b = (const unsigned char*)p;
+        for (size_t i = 0; i < n; i++)
+            h = (h ^ b[i]) * 0x100000001b3ULL;
+    };
+
+    /* Cars and coins only move along with roadOffset and distanceScore.
+       Every live particle loses a tick of life per update, so the first
+       one's life stands in for the whole pool. */
+    long ints[] = { mode, currentSegment, distanceScore, coinScore,
+                    laneCount, traffic.count, particles.count };
+    float floats[] = { roadOffset, playerX, playerY, dayCycle,
+                       windmillAngle, shieldTime, magnetTime,
+                       particles.count ? particles.life[0] : 0.0f };
+
+    mix(ints, sizeof(ints));
+    mix(floats, sizeof(floats));
+
+    /* Player 0 is in the globals above. */
+    for (int p = 1; p < playerCount; p++) {
+        const Runner& s = runners[p];
+        float pos[2] = { s.x, s.y };
+        long state[2] = { s.coins, s.out };
+        mix(pos, sizeof(pos));
+        mix(state, sizeof(state));
+    }
+    return h;
+}
@@ -0,0 +1,247 @@
+#ifndef STREET_RUNNER_GAME_H
+#define STREET_RUNNER_GAME_H
+
+#include <cstdint>
+#include <vector>
+
+/* ========================================================================
+   GAME STATE
+   ========================================================================
+   Everything in this header is free of OpenGL so the simulation can be
+   driven headless (benchmarks, servers). Rendering lives in main.cpp.
+   ======================================================================== */
+
+enum GameMode { MENU, PLAYING, PAUSED, GAMEOVER, COUNTDOWN };
+extern GameMode mode;
+
+extern long distanceScore;
+extern long coinScore;
+extern long highScore;
+
+/* File the high score is kept in; nullptr disables persistence. */
+extern const char* highScoreFile;
+
+extern long currentSegment;
+extern float roadOffset;
+
+extern float scrollSpeed;
+extern float baseScrollSpeed;
+extern float maxScrollSpeed;
+extern float difficultyFactor;
+
+const float segmentLength = 2.0f;
+const int visibleSegments = 40;
+
+extern float playerX;
+extern float playerY;
+extern int currentLane;
+extern float targetX;
+
+/* Lanes are numbered 0 .. laneCount - 1 from the left and centred on
+   x = 0; the classic game has three. */
+const int maxLanes = 64;
+extern int laneCount;
+const float laneWidth = 2.0f;
+extern float roadHalfWidth;
+extern float laneSpeed;
+
+/* Percent chance of a car per lane and segment. */
+extern int carDensity;
+
+/* Cars spawn() moved to another lane of their segment, or left out,
+   because they would have run into another car or left the runner no
+   way through (see reachability.h). */
+extern long movedCars;
+extern long droppedCars;
+
+extern bool isJumping;
+extern float velY;
+const float GRAVITY = 0.025f;
+const float JUMP_FORCE = 0.35f;
+
+/* A car hits the runner within carHitReach of it along the road while
+   the runner is no higher than carRoofHeight. */
+const float carHitReach = 0.8f;
+const float carRoofHeight = 0.75f;
+
+extern float windmillAngle;
+extern float countdownValue;
+
+extern float dayCycle;
+
+struct Coin { long seg; int lane; bool collected; };
+
+/* Cars live in the traffic pool (traffic.h). */
+extern std::vector<Coin> coins;
+
+/* Power-ups sit in a free lane like coins. The magnet collects every
+   coin within magnetRadius of the runner, across lanes; the shield
+   smashes the cars the runner runs into instead of ending the run;
+   slow motion slows the road and the traffic but not the runner. */
+enum PowerUpKind : uint8_t {
+    POWERUP_MAGNET,
+    POWERUP_SHIELD,
+    POWERUP_SLOWMO,
+    powerUpKinds
+};
+
+struct PowerUp { long seg; int lane; uint8_t kind; bool collected; };
+
+extern std::vector<PowerUp> powerUps;
+
+const float magnetRadius = 4.5f;
+const float magnetDuration = 600.0f;        /* ticks */
+const float shieldDuration = 480.0f;
+const float slowMotionDuration = 300.0f;
+const float slowMotionScale = 0.5f;
+
+/* Ticks left on the active runner's magnet and shield, and on the
+   world's slow motion. */
+extern float magnetTime;
+extern float shieldTime;
+extern float slowMotionTime;
+
+/* ========================================================================
+   HIGH SCORE SYSTEM
+   ======================================================================== */
+
+void loadHighScore();
+void saveHighScore();
+
+/* ========================================================================
+   WORLD GENERATION
+   ======================================================================== */
+
+static inline uint32_t hash32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+inline float laneX(int lane) {
+    return (lane - (laneCount - 1) * 0.5f) * laneWidth;
+}
+
+inline float segmentZ(long seg) {
+    return -((seg - currentSegment) * segmentLength + segmentLength * 0.5f);
+}
+
+/* Road covered since resetGame(). The scroll speed ramps up with it,
+   so slow motion holds the ramp back along with the road. */
+inline double roadDistance() {
+    return currentSegment * (double)segmentLength + roadOffset;
+}
+
+float scrollSpeedAt(double distance);
+
+/* Sideways speed of the robot at a given scroll speed. */
+inline float laneSpeedFor(float scroll) {
+    return 0.25f + scroll * 0.4f;
+}
+
+/* Takes effect on the next resetGame(); clamped to 1 .. maxLanes. */
+void setLaneCount(int lanes);
+
+/* ========================================================================
+   SPLIT-SCREEN PLAYERS
+   ========================================================================
+   Up to maxPlayers runners share one road, its traffic and its coins.
+   The player globals above (playerX, currentLane, coinScore ...) always
+   hold the active runner; the others wait in runners[]. tickGame()
+   steps each runner in turn and leaves player 0 active, so single-player
+   code never sees the difference. A runner hit by a car is out; the game
+   is over when every runner is. Snapshots and rewind cover player 0
+   only.
+   ======================================================================== */
+
+const int maxPlayers = 4;
+
+struct Runner {
+    float x, y, targetX, velY;
+    int lane;
+    bool jumping;
+    bool out;
+    long coins;
+    float magnet, shield;
+};
+
+extern Runner runners[maxPlayers];
+extern int playerCount;
+extern int activePlayer;
+
+/* Takes effect on the next resetGame(); clamped to 1 .. maxPlayers. */
+void setPlayerCount(int players);
+
+/* Parks the active runner in runners[] and loads runner p into the
+   player globals. */
+void selectPlayer(int p);
+
+/* Runner p as of now, whether or not it is the active one. */
+Runner playerState(int p);
+
+/* Input for runner p: a lane to the left (-1) or right (+1), and a
+   jump. Ignored once the runner is out. */
+void steerPlayer(int p, int dir);
+void jumpPlayer(int p);
+
+void spawn(long seg);
+void resetGame();
+
+/* ========================================================================
+   SCENERY CACHE
+   ======================================================================== */
+
+/* A segment's scenery never changes while it is on screen, so the
+   placement rules run once when it enters the view window and the
+   result is kept in a ring indexed by segment number. Entries are
+   tagged with their segment and rebuilt on a miss, so a restart needs
+   no explicit flush. */
+
+enum SceneryType : uint8_t {
+    SCENERY_TREE,
+    SCENERY_WINDMILL,
+    SCENERY_HOUSE,
+    SCENERY_CHARACTER
+};
+
+struct SceneryItem {
+    uint8_t type;
+    int8_t side;      /* -1 left of the road, +1 right */
+    float offset;     /* distance from the road edge */
+};
+
+const int maxSceneryPerSegment = 8;
+const int sceneryRingSize = 64;   /* power of two > visibleSegments + 1 */
+
+struct SegmentScenery {
+    long seg;
+    bool built;
+    uint8_t count;
+    SceneryItem items[maxSceneryPerSegment];
+};
+
+extern SegmentScenery sceneryRing[sceneryRingSize];
+
+void buildScenery(long seg);
+const SegmentScenery& sceneryFor(long seg);
+
+/* ========================================================================
+   SIMULATION
+   ======================================================================== */
+
+/* Lane/z tests against the player for the current tick. */
+void checkCollisions();
+
+/* Advances the game by one 16 ms tick. Does not touch GL or GLUT. */
+void tickGame();
+
+/* A hash of everything drawScene() shows that can change between
+   ticks: mode (the menu draws no world), road position, player, cars,
+   day cycle, windmill and live particles. Equal stamps draw the same
+   frame, so a front end can skip redrawing menus and paused screens. */
+uint64_t sceneStamp();
+
+#endif
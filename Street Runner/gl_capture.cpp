@@ -0,0 +1,131 @@
+#include "gl_capture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+#ifdef FREEGLUT
+#include <GL/freeglut_ext.h>
+#endif
+
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_READ_ONLY
+#define GL_READ_ONLY 0x88B8
+#endif
+
+namespace {
+
+typedef void (APIENTRY *GenBuffersFn)(GLsizei, GLuint*);
+typedef void (APIENTRY *DeleteBuffersFn)(GLsizei, const GLuint*);
+typedef void (APIENTRY *BindBufferFn)(GLenum, GLuint);
+typedef void (APIENTRY *BufferDataFn)(GLenum, std::ptrdiff_t,
+                                      const void*, GLenum);
+typedef void* (APIENTRY *MapBufferFn)(GLenum, GLenum);
+typedef GLboolean (APIENTRY *UnmapBufferFn)(GLenum);
+
+GenBuffersFn genBuffers;
+DeleteBuffersFn deleteBuffers;
+BindBufferFn bindBuffer;
+BufferDataFn bufferData;
+MapBufferFn mapBuffer;
+UnmapBufferFn unmapBuffer;
+
+/* Core names first, then the ARB ones. */
+template <typename Fn>
+bool lookUp(Fn& fn, const char* core, const char* arb) {
+#ifdef FREEGLUT
+    fn = (Fn)glutGetProcAddress(core);
+    if (!fn)
+        fn = (Fn)glutGetProcAddress(arb);
+#else
+    (void)core;
+    (void)arb;
+    fn = nullptr;
+#endif
+    return fn != nullptr;
+}
+
+bool loadBufferObjects() {
+    static bool loaded =
+        lookUp(genBuffers, "glGenBuffers", "glGenBuffersARB") &&
+        lookUp(deleteBuffers, "glDeleteBuffers", "glDeleteBuffersARB") &&
+        lookUp(bindBuffer, "glBindBuffer", "glBindBufferARB") &&
+        lookUp(bufferData, "glBufferData", "glBufferDataARB") &&
+        lookUp(mapBuffer, "glMapBuffer", "glMapBufferARB") &&
+        lookUp(unmapBuffer, "glUnmapBuffer", "glUnmapBufferARB");
+    return loaded;
+}
+
+}
+
+GLFrameCapture::GLFrameCapture(FrameEncoder& encoder)
+    : encoder(encoder), pbo(), issued(0), overhead(0.0) {
+
+    if (!loadBufferObjects()) {
+        readback.resize((size_t)encoder.width() * encoder.height() * 4);
+        return;
+    }
+
+    genBuffers(captureLag + 1, pbo);
+    for (GLuint b : pbo) {
+        bindBuffer(GL_PIXEL_PACK_BUFFER, b);
+        bufferData(GL_PIXEL_PACK_BUFFER,
+                   (std::ptrdiff_t)encoder.width() * encoder.height() * 4,
+                   nullptr, GL_STREAM_READ);
+    }
+    bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+GLFrameCapture::~GLFrameCapture() {
+
+    if (!usingPBOs())
+        return;
+
+    for (long k = std::max(issued - captureLag, 0L); k < issued; k++)
+        handOver((int)(k % (captureLag + 1)));
+
+    deleteBuffers(captureLag + 1, pbo);
+}
+
+void GLFrameCapture::handOver(int slot) {
+
+    bindBuffer(GL_PIXEL_PACK_BUFFER, pbo[slot]);
+    const void* p = mapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (p) {
+        encoder.submit((const uint8_t*)p, true);
+        unmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void GLFrameCapture::captureFrame() {
+
+    auto start = std::chrono::steady_clock::now();
+    const int w = encoder.width(), h = encoder.height();
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    if (!usingPBOs()) {
+        glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, readback.data());
+        encoder.submit(readback.data(), true);
+    }
+    else {
+        /* Queue this frame's copy, then collect the one from
+           captureLag frames ago. */
+        bindBuffer(GL_PIXEL_PACK_BUFFER, pbo[issued % (captureLag + 1)]);
+        glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        if (issued >= captureLag)
+            handOver((int)((issued - captureLag) % (captureLag + 1)));
+    }
+
+    issued++;
+    overhead += std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,56 @@
+#ifndef STREET_RUNNER_GL_CAPTURE_H
+#define STREET_RUNNER_GL_CAPTURE_H
+
+#include <GL/glut.h>
+
+#include "capture.h"
+
+/* ========================================================================
+   GL FRAME CAPTURE
+   ========================================================================
+   Reads the back buffer into a ring of pixel buffer objects. The read
+   issued this frame is only mapped captureLag frames later, by which
+   time the copy has finished on the GPU side, so neither glReadPixels
+   nor the map waits for the frame being drawn. Mapped frames go to a
+   FrameEncoder.
+
+   Buffer objects are looked up at run time (GL 1.5 or
+   ARB_pixel_buffer_object, through glutGetProcAddress). Without them
+   each frame is read with a plain, blocking glReadPixels instead.
+   ======================================================================== */
+
+const int captureLag = 2;
+
+class GLFrameCapture {
+public:
+    /* Captures encoder.width() x encoder.height() pixels from the
+       bottom-left corner of the window. Needs a current GL context. */
+    explicit GLFrameCapture(FrameEncoder& encoder);
+
+    /* Hands over the frames still in flight. */
+    ~GLFrameCapture();
+
+    GLFrameCapture(const GLFrameCapture&) = delete;
+    GLFrameCapture& operator=(const GLFrameCapture&) = delete;
+
+    /* Call once per frame after drawing, before swapping buffers. */
+    void captureFrame();
+
+    bool usingPBOs() const { return pbo[0] != 0; }
+    long frames() const { return issued; }
+
+    /* Render-thread time spent in captureFrame(), encoder hand-off
+       included. */
+    double overheadSeconds() const { return overhead; }
+
+private:
+    void handOver(int slot);
+
+    FrameEncoder& encoder;
+    GLuint pbo[captureLag + 1];
+    std::vector<uint8_t> readback;    /* without PBOs */
+    long issued;
+    double overhead;
+};
+
+#endif
@@ -0,0 +1,212 @@
+#include "gl_renderer.h"
+
+/* The quadric is created lazily: the renderer may be constructed before
+   glutCreateWindow() has made a context current. */
+
+GLRenderer::GLRenderer()
+    : quadric(nullptr), viewportWidth(0), viewportHeight(0) {}
+
+GLRenderer::~GLRenderer() {
+    if (quadric)
+        gluDeleteQuadric(quadric);
+}
+
+int GLRenderer::width() const {
+    return viewportWidth ? viewportWidth : glutGet(GLUT_WINDOW_WIDTH);
+}
+
+int GLRenderer::height() const {
+    return viewportHeight ? viewportHeight : glutGet(GLUT_WINDOW_HEIGHT);
+}
+
+void GLRenderer::setViewport(int x, int y, int w, int h) {
+
+    /* The scissor keeps wide points and lines from spilling over
+       into the neighbouring viewport. */
+    if (w <= 0 || h <= 0) {
+        viewportWidth = viewportHeight = 0;
+        glViewport(0, 0, width(), height());
+        glDisable(GL_SCISSOR_TEST);
+        return;
+    }
+
+    viewportWidth = w;
+    viewportHeight = h;
+    glViewport(x, y, w, h);
+    glScissor(x, y, w, h);
+    glEnable(GL_SCISSOR_TEST);
+}
+
+void GLRenderer::clear() {
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void GLRenderer::setPerspective(float fovy, float aspect,
+                                float zn, float zf) {
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    gluPerspective(fovy, aspect, zn, zf);
+    glMatrixMode(GL_MODELVIEW);
+}
+
+void GLRenderer::beginOverlay() {
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    gluOrtho2D(0, width(), 0, height());
+
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+}
+
+void GLRenderer::endOverlay() {
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+void GLRenderer::setCamera(float ex, float ey, float ez,
+                           float cx, float cy, float cz,
+                           float ux, float uy, float uz) {
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    gluLookAt(ex, ey, ez, cx, cy, cz, ux, uy, uz);
+}
+
+void GLRenderer::setLightPosition(float x, float y, float z, float w) {
+    GLfloat pos[] = { x, y, z, w };
+    glLightfv(GL_LIGHT0, GL_POSITION, pos);
+}
+
+void GLRenderer::setLighting(bool on) {
+    if (on) glEnable(GL_LIGHTING); else glDisable(GL_LIGHTING);
+}
+
+void GLRenderer::setDepthTest(bool on) {
+    if (on) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
+}
+
+void GLRenderer::setBlend(BlendMode blend) {
+
+    if (blend == BLEND_NONE) {
+        glDisable(GL_BLEND);
+        return;
+    }
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA,
+                blend == BLEND_ADDITIVE ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void GLRenderer::setLineWidth(float w) { glLineWidth(w); }
+
+void GLRenderer::pushMatrix() { glPushMatrix(); }
+void GLRenderer::popMatrix() { glPopMatrix(); }
+
+void GLRenderer::translate(float x, float y, float z) {
+    glTranslatef(x, y, z);
+}
+
+void GLRenderer::rotate(float angle, float x, float y, float z) {
+    glRotatef(angle, x, y, z);
+}
+
+void GLRenderer::scale(float x, float y, float z) { glScalef(x, y, z); }
+
+void GLRenderer::color(float r, float g, float b, float a) {
+    glColor4f(r, g, b, a);
+}
+
+void GLRenderer::normal(float x, float y, float z) { glNormal3f(x, y, z); }
+
+void GLRenderer::begin(PrimitiveType prim) {
+    static const GLenum modes[] = { GL_POINTS, GL_TRIANGLES, GL_QUADS };
+    glBegin(modes[prim]);
+}
+
+void GLRenderer::vertex(float x, float y, float z) { glVertex3f(x, y, z); }
+void GLRenderer::end() { glEnd(); }
+
+void GLRenderer::drawPointArray(const float* xyz, const float* rgba,
+                                int count, float size) {
+
+    glPointSize(size);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+
+    glVertexPointer(3, GL_FLOAT, 0, xyz);
+    glColorPointer(4, GL_FLOAT, 0, rgba);
+    glDrawArrays(GL_POINTS, 0, count);
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glPointSize(1.0f);
+}
+
+void GLRenderer::drawTriangleArray(const float* xyz, const float* normals,
+                                   const float* rgba, int count) {
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+
+    glVertexPointer(3, GL_FLOAT, 0, xyz);
+    glNormalPointer(GL_FLOAT, 0, normals);
+    glColorPointer(4, GL_FLOAT, 0, rgba);
+    glDrawArrays(GL_TRIANGLES, 0, count);
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+void GLRenderer::solidCube(float size) { glutSolidCube(size); }
+
+void GLRenderer::solidSphere(float radius, int slices, int stacks) {
+    glutSolidSphere(radius, slices, stacks);
+}
+
+void GLRenderer::solidCone(float base, float height,
+                           int slices, int stacks) {
+    glutSolidCone(base, height, slices, stacks);
+}
+
+void GLRenderer::cylinder(float base, float top, float height,
+                          int slices, int stacks) {
+    if (!quadric)
+        quadric = gluNewQuadric();
+    gluCylinder(quadric, base, top, height, slices, stacks);
+}
+
+void GLRenderer::solidTorus(float inner, float outer,
+                            int sides, int rings) {
+    glutSolidTorus(inner, outer, sides, rings);
+}
+
+void GLRenderer::drawSolidInstances(const SolidShape& s,
+                                    const Mat4* models, int count) {
+
+    /* The modelview is read once per batch and each instance loads
+       view * model outright, which keeps the matrix stack out of the
+       loop; the modelview matrix is client-side state in the fixed
+       function pipeline, so reading it does not wait on the GPU. */
+    if (count <= 0)
+        return;
+    Mat4 view;
+    glGetFloatv(GL_MODELVIEW_MATRIX, view.m);
+
+    for (int k = 0; k < count; k++) {
+        glLoadMatrixf(mat4Multiply(view, models[k]).m);
+        switch (s.kind) {
+            case SOLID_CUBE:     solidCube(s.a);                          break;
+            case SOLID_SPHERE:   solidSphere(s.a, s.i, s.j);              break;
+            case SOLID_CONE:     solidCone(s.a, s.b, s.i, s.j);           break;
+            case SOLID_CYLINDER: cylinder(s.a, s.b, s.c, s.i, s.j);       break;
+            case SOLID_TORUS:    solidTorus(s.a, s.b, s.i, s.j);          break;
+        }
+    }
+    glLoadMatrixf(view.m);
+}
@@ -0,0 +1,75 @@
+#ifndef STREET_RUNNER_GL_RENDERER_H
+#define STREET_RUNNER_GL_RENDERER_H
+
+#include <GL/glut.h>
+
+#include "renderer.h"
+
+/* ========================================================================
+   GL RENDERER
+   ========================================================================
+   Forwards every Renderer call to fixed-function GL / GLUT in the
+   current window.
+   ======================================================================== */
+
+class GLRenderer : public Renderer {
+public:
+    GLRenderer();
+    ~GLRenderer();
+
+    int width() const override;
+    int height() const override;
+    void setViewport(int x, int y, int w, int h) override;
+
+    void clear() override;
+
+    void setPerspective(float fovy, float aspect,
+                        float zn, float zf) override;
+    void beginOverlay() override;
+    void endOverlay() override;
+
+    void setCamera(float ex, float ey, float ez,
+                   float cx, float cy, float cz,
+                   float ux, float uy, float uz) override;
+    void setLightPosition(float x, float y, float z, float w) override;
+
+    void setLighting(bool on) override;
+    void setDepthTest(bool on) override;
+    void setBlend(BlendMode blend) override;
+    void setLineWidth(float w) override;
+
+    void pushMatrix() override;
+    void popMatrix() override;
+    void translate(float x, float y, float z) override;
+    void rotate(float angle, float x, float y, float z) override;
+    void scale(float x, float y, float z) override;
+
+    void color(float r, float g, float b, float a) override;
+    void normal(float x, float y, float z) override;
+
+    void begin(PrimitiveType prim) override;
+    void vertex(float x, float y, float z) override;
+    void end() override;
+
+    void drawPointArray(const float* xyz, const float* rgba,
+                        int count, float size) override;
+    void drawTriangleArray(const float* xyz, const float* normals,
+                           const float* rgba, int count) override;
+
+    void solidCube(float size) override;
+    void solidSphere(float radius, int slices, int stacks) override;
+    void solidCone(float base, float height,
+                   int slices, int stacks) override;
+    void cylinder(float base, float top, float height,
+                  int slices, int stacks) override;
+    void solidTorus(float inner, float outer,
+                    int sides, int rings) override;
+    void drawSolidInstances(const SolidShape& shape,
+                            const Mat4* models, int count) override;
+
+private:
+    GLUquadric* quadric;
+    int viewportWidth, viewportHeight;     /* 0: whole window */
+};
+
+#endif
@@ -1,159 +1,37 @@
 #include <GL/glut.h>
+#ifdef FREEGLUT
+#include <GL/freeglut_ext.h>
+#endif
 #include <cmath>
 #include <vector>
 #include <cstdio>
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
+#include <ctime>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <algorithm>
+
+#include "game.h"
+#include "scene.h"
+#include "gl_renderer.h"
+#include "snapshot.h"
+#include "gl_capture.h"
 /* ===== FUNCTION DECLARATIONS ===== */
 
 void display();
 void reshape(int w, int h);
 void keys(unsigned char k, int x, int y);
+void specialKeys(int k, int x, int y);
 void update(int value);
 
 
-/* ========================================================================
-   SECTION 1: GLOBAL SETTINGS & VARIABLES
-   ======================================================================== */
-
-enum GameMode { MENU, PLAYING, PAUSED, GAMEOVER, COUNTDOWN };
-GameMode mode = MENU;
-
-long distanceScore = 0;
-long coinScore = 0;
-long highScore = 0;
-
-long currentSegment = 0;
-float roadOffset = 0.0f;
-
-float scrollSpeed = 0.15f;
-float baseScrollSpeed = 0.15f;
-float maxScrollSpeed  = 0.45f;
-float difficultyFactor = 0.0000025f;
-
-const float segmentLength = 2.0f;
-const int visibleSegments = 40;
-
-float playerX = 0.0f;
-float playerY = 0.5f;
-int currentLane = 0;
-float targetX = 0.0f;
-
-const float laneWidth = 2.0f;
-const float roadHalfWidth = 3.3f;
-float laneSpeed = 0.3f;
+GLRenderer glRenderer;
 
-bool isJumping = false;
-float velY = 0.0f;
-const float GRAVITY = 0.025f;
-const float JUMP_FORCE = 0.35f;
-
-float windmillAngle = 0.0f;
-float countdownValue = 3.0f;
-
-float dayCycle = 0.0f;
-
-struct Car { long seg; int lane; };
-struct Coin { long seg; int lane; bool collected; };
-
-std::vector<Car> cars;
-std::vector<Coin> coins;
-
-/* ========================================================================
-   HIGH SCORE SYSTEM
-   ======================================================================== */
-
-void loadHighScore() {
-    FILE* f = fopen("highscore.txt", "r");
-    if (f) { fscanf(f, "%ld", &highScore); fclose(f); }
-}
-
-void saveHighScore() {
-    if (distanceScore > highScore) {
-        highScore = distanceScore;
-        FILE* f = fopen("highscore.txt", "w");
-        if (f) { fprintf(f, "%ld", highScore); fclose(f); }
-    }
-}
-
-/* ========================================================================
-   CUSTOM ALGORITHMS
-   ======================================================================== */
-
-void drawLineDDA(float x1, float y1, float z1,
-                 float x2, float y2, float z2) {
-
-    float dx = x2 - x1;
-    float dy = y2 - y1;
-    float dz = z2 - z1;
-
-    float steps = std::max(std::abs(dx),
-                   std::max(std::abs(dy), std::abs(dz)));
-
-    if (steps == 0) {
-        glBegin(GL_POINTS);
-        glVertex3f(x1, y1, z1);
-        glEnd();
-        return;
-    }
-
-    float xInc = dx / steps;
-    float yInc = dy / steps;
-    float zInc = dz / steps;
-
-    float x = x1, y = y1, z = z1;
-
-    glBegin(GL_POINTS);
-    for (int i = 0; i <= steps; i++) {
-        glVertex3f(x, y, z);
-        x += xInc;
-        y += yInc;
-        z += zInc;
-    }
-    glEnd();
-}
-
-void drawMidpointCirclePoints(int radius, float pixelScale) {
-
-    int x = 0;
-    int y = radius;
-    int p = 1 - radius;
-
-    glBegin(GL_POINTS);
-
-    while (x <= y) {
-
-        float fx = x * pixelScale;
-        float fy = y * pixelScale;
-
-        glVertex3f( fx,  fy, 0);
-        glVertex3f( fy,  fx, 0);
-        glVertex3f(-fx,  fy, 0);
-        glVertex3f(-fy,  fx, 0);
-        glVertex3f(-fx, -fy, 0);
-        glVertex3f(-fy, -fx, 0);
-        glVertex3f( fx, -fy, 0);
-        glVertex3f( fy, -fx, 0);
-
-        x++;
-
-        if (p < 0)
-            p += 2 * x + 1;
-        else {
-            y--;
-            p += 2 * x - 2 * y + 1;
-        }
-    }
-
-    glEnd();
-}
-
-void drawFilledMidpointCircle(int radius, float scale) {
-    for (int r = 0; r <= radius; r++)
-        drawMidpointCirclePoints(r, scale);
-}
+/* Ticks the B key rewinds after a crash. */
+const long rewindOnCrash = 180;
 
 /* ========================================================================
    TEXT HELPERS
@@ -193,703 +71,428 @@ void drawText(const char* s,
     glEnable(GL_LIGHTING);
 }
 
-void drawCenteredText(const char* s,
-                      float y,
-                      float r, float g, float b) {
-
-    int w = glutGet(GLUT_WINDOW_WIDTH);
-    int stringWidth = 0;
-
-    for (const char* p = s; *p; p++)
-        stringWidth += glutBitmapWidth(GLUT_BITMAP_TIMES_ROMAN_24, *p);
-
-    drawText(s,
-             (w - stringWidth) / 2.0f,
-             y, r, g, b);
-}
-
 /* ========================================================================
-   BACKGROUND WITH DAYNIGHT CYCLE
+   OVERLAY
+   ========================================================================
+   The menu / HUD / prompt text for the current state as plain data, so
+   update() can tell whether the text on screen is still current.
    ======================================================================== */
 
-void drawCloud2D(float cx, float cy, float scale) {
-
-    glPushMatrix();
-    glTranslatef(cx, cy, 0);
-    glScalef(scale, scale * 0.6f, 1.0f);
-
-    glColor4f(1.0f, 1.0f, 1.0f, 0.8f);
-
-    glPushMatrix(); glTranslatef(-30, -10, 0);
-    drawFilledMidpointCircle(25, 1.0f);
-    glPopMatrix();
-
-    glPushMatrix(); glTranslatef(0, 0, 0);
-    drawFilledMidpointCircle(35, 1.0f);
-    glPopMatrix();
-
-    glPushMatrix(); glTranslatef(30, -10, 0);
-    drawFilledMidpointCircle(25, 1.0f);
-    glPopMatrix();
-
-    glPushMatrix(); glTranslatef(15, 15, 0);
-    drawFilledMidpointCircle(20, 1.0f);
-    glPopMatrix();
-
-    glPopMatrix();
+const int maxOverlayLines = 12;
+
+struct OverlayLine {
+    char text[64];
+    float x, y;
+    float r, g, b;
+};
+
+struct Overlay {
+    int count;
+    OverlayLine lines[maxOverlayLines];
+};
+
+void addText(Overlay& o, const char* s, float x, float y,
+             float r, float g, float b) {
+
+    OverlayLine& l = o.lines[o.count++];
+    std::snprintf(l.text, sizeof(l.text), "%s", s);
+    l.x = x;
+    l.y = y;
+    l.r = r;
+    l.g = g;
+    l.b = b;
 }
 
-void drawAttractiveBackground() {
+void addCenteredText(Overlay& o, const char* s, float y,
+                     float r, float g, float b) {
 
     int w = glutGet(GLUT_WINDOW_WIDTH);
-    int h = glutGet(GLUT_WINDOW_HEIGHT);
-
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-    gluOrtho2D(0, w, 0, h);
-
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
-
-    float t = (sin(dayCycle) + 1.0f) * 0.5f;
-
-    glBegin(GL_QUADS);
-
-    glColor3f(0.05f + 0.3f*t,
-              0.2f  + 0.4f*t,
-              0.4f  + 0.4f*t);
-    glVertex2f(0, h);
-    glVertex2f(w, h);
-
-    glColor3f(0.0f + 0.2f*t,
-              0.1f + 0.3f*t,
-              0.2f + 0.6f*t);
-    glVertex2f(w, 0);
-    glVertex2f(0, 0);
-
-    glEnd();
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA,
-                GL_ONE_MINUS_SRC_ALPHA);
-
-    drawCloud2D(w * 0.2f, h * 0.85f, 1.5f);
-    drawCloud2D(w * 0.75f, h * 0.75f, 2.0f);
-    drawCloud2D(w * 0.45f, h * 0.9f, 1.2f);
-
-    glPushMatrix();
-    glTranslatef(w * 0.85f, h * 0.85f, 0);
-    glColor3f(1.0f, 1.0f, 0.0f);
-    drawFilledMidpointCircle(60, 1.0f);
-    glPopMatrix();
-
-    glDisable(GL_BLEND);
+    int stringWidth = 0;
 
-    glPopMatrix();
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
+    for (const char* p = s; *p; p++)
+        stringWidth += glutBitmapWidth(GLUT_BITMAP_TIMES_ROMAN_24, *p);
 
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    addText(o, s, (w - stringWidth) / 2.0f, y, r, g, b);
 }
-/* ========================================================================
-   3D MODELS AND SCENERY
-   ======================================================================== */
 
-void drawTree(float x, float z) {
+void buildOverlay(Overlay& o) {
 
-    glColor3f(0.55f, 0.27f, 0.07f);
-
-    glPushMatrix();
-    glTranslatef(x, 0.0f, z);
-    glRotatef(-90, 1, 0, 0);
+    int w = glutGet(GLUT_WINDOW_WIDTH);
+    int h = glutGet(GLUT_WINDOW_HEIGHT);
 
-    GLUquadric* q = gluNewQuadric();
-    gluCylinder(q, 0.25f, 0.25f, 1.5f, 8, 1);
-    gluDeleteQuadric(q);
+    /* Zeroed whole so two overlays compare with memcmp. */
+    std::memset(&o, 0, sizeof(o));
 
-    glPopMatrix();
+    if (mode == MENU) {
 
-    glColor3f(0.1f, 0.7f, 0.1f);
+        addCenteredText(o, "STREET RUNNER", h * 0.7f, 1,1,1);
+        addCenteredText(o, "Press ENTER to Start Game", h * 0.55f, 1,1,1);
+        addCenteredText(o, "Controls: A/D move, SPACE jump, ESC pause", h * 0.45f, 1,1,1);
+        if (playerCount > 1)
+            addCenteredText(o, "P2: J/L, I   P3: arrows   P4: 4/6, 8", h * 0.4f, 1,1,1);
+        addCenteredText(o, "Developed by Nasif Abdullah", h * 0.35f, 1,1,1);
+        return;
+    }
 
-    glPushMatrix();
-    glTranslatef(x, 1.5f, z);
-    glRotatef(-90, 1, 0, 0);
-    glutSolidCone(1.0f, 2.3f, 10, 2);
-    glPopMatrix();
-}
+    /* HUD */
+
+    char s1[64], s2[64], s3[64];
+
+    std::snprintf(s1, sizeof(s1), "Distance: %ld", distanceScore);
+    std::snprintf(s2, sizeof(s2), "Coins: %ld", coinScore);
+    std::snprintf(s3, sizeof(s3), "High Score: %ld", highScore);
+
+    addText(o, s1, 20, h - 50, 1,1,1);
+    addText(o, s3, 20, h - 80, 0,1,1);
+
+    /* Power-ups still running; slow motion is shared. */
+    char s4[64];
+    std::snprintf(s4, sizeof(s4), "%s%s%s",
+                  playerCount == 1 && magnetTime > 0.0f ? "Magnet  " : "",
+                  playerCount == 1 && shieldTime > 0.0f ? "Shield  " : "",
+                  slowMotionTime > 0.0f ? "Slow motion" : "");
+    if (s4[0])
+        addText(o, s4, 20, h - 140, 0.8f,0.5f,1);
+
+    /* Split screen: coins in the corner of each player's view. */
+    if (playerCount == 1)
+        addText(o, s2, 20, h - 110, 1,1,0);
+    else
+        for (int p = 0; p < playerCount; p++) {
+            Runner s = playerState(p);
+            Viewport vp = splitScreenViewport(p, playerCount, w, h);
+            std::snprintf(s2, sizeof(s2), "P%d Coins: %ld%s%s%s",
+                          p + 1, s.coins,
+                          s.magnet > 0.0f ? "  Magnet" : "",
+                          s.shield > 0.0f ? "  Shield" : "",
+                          s.out ? "  OUT" : "");
+            addText(o, s2, vp.x + 20, vp.y + 20,
+                    1, s.out ? 0.3f : 1, s.out ? 0.3f : 0);
+        }
 
-/* ---------------------------------------------------------------------- */
+    /* PAUSE SCREEN */
 
-void drawWindmill(float x, float z) {
+    if (mode == PAUSED) {
+        addCenteredText(o, "PAUSED", h * 0.65f, 1,1,1);
+        addCenteredText(o, "Press ESC to Resume", h * 0.55f, 1,1,0);
+        addCenteredText(o, "Press Q to Quit", h * 0.45f, 1,0,0);
+    }
 
-    glColor3f(0.85f, 0.85f, 0.85f);
+    /* COUNTDOWN SCREEN */
 
-    glPushMatrix();
-    glTranslatef(x, 0.0f, z);
-    glRotatef(-90, 1, 0, 0);
+    if (mode == COUNTDOWN) {
+        char cStr[8];
+        std::snprintf(cStr, sizeof(cStr), "%d",
+                      (int)ceil(countdownValue));
 
-    GLUquadric* q = gluNewQuadric();
-    gluCylinder(q, 0.5f, 0.25f, 5.0f, 12, 1);
-    gluDeleteQuadric(q);
+        addCenteredText(o, "GET READY", h * 0.65f, 1,1,1);
+        addCenteredText(o, cStr, h * 0.55f, 1,1,0);
+    }
 
-    glPopMatrix();
+    /* GAME OVER SCREEN */
 
-    glPushMatrix();
-    glTranslatef(x, 5.0f, z);
-    glRotatef(windmillAngle, 0, 0, 1);
-
-    glColor3f(0.8f, 0.0f, 0.0f);
-
-    for (int i = 0; i < 4; i++) {
-        glPushMatrix();
-        glRotatef(90.0f * i, 0, 0, 1);
-        glTranslatef(0, 1.5f, 0);
-        glScalef(0.4f, 3.0f, 0.1f);
-        glutSolidCube(1.0f);
-        glPopMatrix();
+    if (mode == GAMEOVER) {
+        addCenteredText(o, "GAME OVER", h * 0.6f, 1,0,0);
+        addCenteredText(o, "Press R to Restart", h * 0.5f, 1,1,1);
+        if (playerCount == 1 && rewindAvailable() >= rewindOnCrash)
+            addCenteredText(o, "Press B to Rewind", h * 0.4f, 1,1,0);
     }
-
-    glPopMatrix();
 }
 
-/* ---------------------------------------------------------------------- */
-
-void drawCartoonHouse(float x, float z) {
-
-    glPushMatrix();
-    glTranslatef(x, 0, z);
-    glScalef(2.5f, 2.5f, 2.5f);
-    glLineWidth(3.0f);
-
-    glColor3f(1.0f, 1.0f, 1.0f);
-    drawLineDDA(-1, 0, 0, -1, 1, 0);
-    drawLineDDA(1, 0, 0, 1, 1, 0);
-    drawLineDDA(-1, 0, 0, 1, 0, 0);
-    drawLineDDA(-1, 1, 0, 1, 1, 0);
-
-    glColor3f(1.0f, 0.0f, 0.0f);
-    drawLineDDA(-1.2f, 1, 0, 0, 1.8f, 0);
-    drawLineDDA(1.2f, 1, 0, 0, 1.8f, 0);
-    drawLineDDA(-1.2f, 1, 0, 1.2f, 1, 0);
-
-    glColor3f(0.6f, 0.3f, 0.1f);
-    drawLineDDA(-0.3f, 0, 0, -0.3f, 0.6f, 0);
-    drawLineDDA(0.3f, 0, 0, 0.3f, 0.6f, 0);
-    drawLineDDA(-0.3f, 0.6f, 0, 0.3f, 0.6f, 0);
-
-    glColor3f(1.0f, 1.0f, 0.0f);
-    glPushMatrix();
-    glTranslatef(0.15f, 0.3f, 0.05f);
-    drawFilledMidpointCircle(3, 0.02f);
-    glPopMatrix();
-
-    glLineWidth(1.0f);
-    glPopMatrix();
+void drawOverlay(const Overlay& o) {
+    for (int i = 0; i < o.count; i++) {
+        const OverlayLine& l = o.lines[i];
+        drawText(l.text, l.x, l.y, l.r, l.g, l.b);
+    }
 }
 
-/* ---------------------------------------------------------------------- */
-
-void drawCartoonCharacter(float x, float z) {
-
-    glPushMatrix();
-    glTranslatef(x, 0.7f, z);
-    glScalef(1.5f, 1.5f, 1.5f);
-
-    float bob = sin(distanceScore * 0.1f + x) * 0.05f;
-    glTranslatef(0, bob, 0);
-
-    glLineWidth(3.0f);
-    glColor3f(1.0f, 0.8f, 0.6f);
-
-    glPushMatrix();
-    glTranslatef(0, 0.6f, 0);
-    drawFilledMidpointCircle(8, 0.02f);
-    glPopMatrix();
-
-    glColor3f(0.0f, 0.8f, 0.0f);
-    drawLineDDA(0, 0.6f, 0, 0, 0.2f, 0);
-
-    float wave = std::abs(sin(distanceScore * 0.2f + z)) * 0.3f;
-
-    drawLineDDA(0, 0.5f, 0, -0.3f, 0.4f, 0);
-    drawLineDDA(0, 0.5f, 0,  0.3f, 0.4f + wave, 0);
-
-    glColor3f(0.0f, 0.0f, 0.8f);
-    drawLineDDA(0, 0.2f, 0, -0.2f, -0.5f, 0);
-    drawLineDDA(0, 0.2f, 0,  0.2f, -0.5f, 0);
+/* ========================================================================
+   REDRAW TRACKING
+   ========================================================================
+   update() asks GLUT for a frame only when the scene stamp (game.h)
+   moved. When only the text changed, e.g. a countdown digit or the
+   pause prompt, the back buffer is filled from a copy of the scene
+   taken before the text went on, the new text drawn over it and the
+   buffers swapped. Full frames outside PLAYING keep that copy, since
+   those screens mostly stand still.
+   ======================================================================== */
 
-    glLineWidth(1.0f);
-    glPopMatrix();
+bool frameShown = false;        /* the window shows shownStamp/shownOverlay */
+uint64_t shownStamp = 0;
+Overlay shownOverlay;
+
+GLuint sceneCopy = 0;
+bool sceneCopyValid = false;
+uint64_t sceneCopyStamp = 0;
+int copyWidth = 0, copyHeight = 0;    /* window size it was taken at */
+int copyTexWidth = 0, copyTexHeight = 0;
+
+int nextPowerOfTwo(int v) {
+    int p = 1;
+    while (p < v)
+        p <<= 1;
+    return p;
 }
 
-/* ---------------------------------------------------------------------- */
-/* COIN WITH GLOW (no algorithm removed) */
-/* ---------------------------------------------------------------------- */
-
-void drawCoin(float x, float z) {
-
-    glPushMatrix();
-    glTranslatef(x, 0.9f, z);
-    glRotatef((float)(distanceScore % 360) * 4.0f, 0, 1, 0);
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-
-    glColor4f(1.0f, 0.85f, 0.0f, 0.8f);
+void saveSceneCopy(uint64_t stamp) {
 
-    drawFilledMidpointCircle(12, 0.02f);
-
-    glPushMatrix();
-    glTranslatef(0, 0, 0.05f);
-    drawFilledMidpointCircle(12, 0.02f);
-    glPopMatrix();
+    int w = glutGet(GLUT_WINDOW_WIDTH);
+    int h = glutGet(GLUT_WINDOW_HEIGHT);
 
-    glPushMatrix();
-    glTranslatef(0, 0, -0.05f);
-    drawFilledMidpointCircle(12, 0.02f);
-    glPopMatrix();
+    if (!sceneCopy)
+        glGenTextures(1, &sceneCopy);
+    glBindTexture(GL_TEXTURE_2D, sceneCopy);
+
+    /* Power-of-two storage keeps this within GL 1.1. */
+    if (nextPowerOfTwo(w) != copyTexWidth ||
+        nextPowerOfTwo(h) != copyTexHeight) {
+        copyTexWidth = nextPowerOfTwo(w);
+        copyTexHeight = nextPowerOfTwo(h);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, copyTexWidth, copyTexHeight,
+                     0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    }
 
-    glDisable(GL_BLEND);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, w, h);
+    glBindTexture(GL_TEXTURE_2D, 0);
 
-    glPopMatrix();
+    copyWidth = w;
+    copyHeight = h;
+    sceneCopyStamp = stamp;
+    sceneCopyValid = true;
 }
 
-/* ---------------------------------------------------------------------- */
-/* ROBOT WITH SHADOW */
-/* ---------------------------------------------------------------------- */
-
-void drawRobot() {
+void drawSceneCopy() {
 
-    float runAnim =
-        (mode == PLAYING)
-        ? sin(distanceScore * 0.2f) * 30.0f
-        : 0.0f;
+    float u = (float)copyWidth / copyTexWidth;
+    float v = (float)copyHeight / copyTexHeight;
 
-    /* SHADOW */
     glDisable(GL_LIGHTING);
-    glColor4f(0, 0, 0, 0.3f);
-    glPushMatrix();
-    glTranslatef(playerX, 0.01f, 0.0f);
-    glScalef(1.0f, 0.1f, 1.2f);
-    glutSolidSphere(0.4f, 12, 12);
-    glPopMatrix();
-    glEnable(GL_LIGHTING);
-
-    /* BODY */
-    glPushMatrix();
-    glTranslatef(playerX, playerY + 0.6f, 0.0f);
-    glScalef(0.65f, 0.65f, 0.65f);
-
-    glColor3f(0.2f, 0.2f, 0.8f);
-    glPushMatrix();
-    glScalef(0.6f, 0.8f, 0.4f);
-    glutSolidCube(1.0f);
-    glPopMatrix();
-
-    glColor3f(0.9f, 0.9f, 0.9f);
-    glPushMatrix();
-    glTranslatef(0.0f, 0.7f, 0.0f);
-    glutSolidSphere(0.35f, 12, 12);
-    glPopMatrix();
-
-    glColor3f(0.6f, 0.6f, 0.6f);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, sceneCopy);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
 
+    glMatrixMode(GL_PROJECTION);
     glPushMatrix();
-    glTranslatef(0.4f, 0.2f, 0.0f);
-    glRotatef(runAnim, 1, 0, 0);
-    glTranslatef(0.0f, -0.35f, 0.0f);
-    glScalef(0.15f, 0.7f, 0.15f);
-    glutSolidCube(1.0f);
-    glPopMatrix();
+    glLoadIdentity();
+    gluOrtho2D(0, copyWidth, 0, copyHeight);
 
+    glMatrixMode(GL_MODELVIEW);
     glPushMatrix();
-    glTranslatef(-0.4f, 0.2f, 0.0f);
-    glRotatef(-runAnim, 1, 0, 0);
-    glTranslatef(0.0f, -0.35f, 0.0f);
-    glScalef(0.15f, 0.7f, 0.15f);
-    glutSolidCube(1.0f);
-    glPopMatrix();
+    glLoadIdentity();
 
-    glColor3f(0.2f, 0.2f, 0.6f);
+    glBegin(GL_QUADS);
+    glTexCoord2f(0, 0); glVertex2f(0, 0);
+    glTexCoord2f(u, 0); glVertex2f((float)copyWidth, 0);
+    glTexCoord2f(u, v); glVertex2f((float)copyWidth, (float)copyHeight);
+    glTexCoord2f(0, v); glVertex2f(0, (float)copyHeight);
+    glEnd();
 
-    glPushMatrix();
-    glTranslatef(0.15f, -0.55f, 0.0f);
-    glRotatef(-runAnim, 1, 0, 0);
-    glTranslatef(0.0f, -0.45f, 0.0f);
-    glScalef(0.2f, 0.9f, 0.2f);
-    glutSolidCube(1.0f);
     glPopMatrix();
-
-    glPushMatrix();
-    glTranslatef(-0.15f, -0.55f, 0.0f);
-    glRotatef(runAnim, 1, 0, 0);
-    glTranslatef(0.0f, -0.45f, 0.0f);
-    glScalef(0.2f, 0.9f, 0.2f);
-    glutSolidCube(1.0f);
+    glMatrixMode(GL_PROJECTION);
     glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
 
-    glPopMatrix();
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_LIGHTING);
 }
-/* ========================================================================
-   CAR MODEL
-   ======================================================================== */
-
-void drawCar(float x, float z) {
-
-    glPushMatrix();
-    glTranslatef(x, 0.35f, z);
-
-    glColor3f(0.85f, 0.1f, 0.1f);
-    glPushMatrix();
-    glScalef(1.4f, 0.6f, 2.0f);
-    glutSolidCube(1.0f);
-    glPopMatrix();
 
-    glColor3f(0.75f, 0.05f, 0.05f);
-    glPushMatrix();
-    glTranslatef(0.0f, 0.45f, -0.2f);
-    glScalef(1.0f, 0.45f, 1.0f);
-    glutSolidCube(1.0f);
-    glPopMatrix();
+/* Shows new text over the copy of the scene; false if there is no
+   copy to draw it over. The whole copy is drawn, not just the text's
+   rectangle: after a swap the back buffer holds nothing defined. */
+bool redrawOverlay(const Overlay& o, uint64_t stamp) {
 
-    glColor3f(0.1f, 0.1f, 0.1f);
+    if (!sceneCopyValid || sceneCopyStamp != stamp ||
+        copyWidth != glutGet(GLUT_WINDOW_WIDTH) ||
+        copyHeight != glutGet(GLUT_WINDOW_HEIGHT))
+        return false;
 
-    for (int sx = -1; sx <= 1; sx += 2)
-        for (int sz = -1; sz <= 1; sz += 2) {
-            glPushMatrix();
-            glTranslatef(0.55f * sx, -0.35f, 0.75f * sz);
-            glutSolidTorus(0.05f, 0.13f, 10, 16);
-            glPopMatrix();
-        }
+    drawSceneCopy();
+    drawOverlay(o);
+    glutSwapBuffers();
 
-    glPopMatrix();
+    shownOverlay = o;
+    return true;
 }
 
 /* ========================================================================
-   WORLD GENERATION
+   CPU USE PER MODE
+   ========================================================================
+   Process CPU time and wall time are charged to the mode that was
+   current between two ticks, and printed as CPU seconds per minute on
+   exit.
    ======================================================================== */
 
-static inline uint32_t hash32(uint32_t x) {
-    x ^= x >> 16;
-    x *= 0x7feb352dU;
-    x ^= x >> 15;
-    x *= 0x846ca68bU;
-    x ^= x >> 16;
-    return x;
-}
+const char* const modeNames[] = {
+    "MENU", "PLAYING", "PAUSED", "GAMEOVER", "COUNTDOWN"
+};
 
-float laneX(int lane) { return lane * laneWidth; }
+double modeCpuSeconds[5];
+double modeWallSeconds[5];
+GameMode chargedMode = MENU;
+std::clock_t lastCpu = 0;
+int lastWallMs = 0;
 
-float segmentZ(long seg) {
-    return -((seg - currentSegment) * segmentLength + segmentLength * 0.5f);
-}
+void chargeTime() {
 
-void spawn(long seg) {
+    std::clock_t cpu = std::clock();
+    int wallMs = glutGet(GLUT_ELAPSED_TIME);
 
-    uint32_t h = hash32((uint32_t)seg ^ 0xA53C9E11U);
-    int safeLane = (int)(h % 3) - 1;
+    modeCpuSeconds[chargedMode] += (double)(cpu - lastCpu) / CLOCKS_PER_SEC;
+    modeWallSeconds[chargedMode] += (wallMs - lastWallMs) / 1000.0;
 
-    for (int lane = -1; lane <= 1; lane++) {
-        if (lane != safeLane &&
-            (int)(hash32(h ^ (lane + 7) * 123u) % 100) < 15)
-            cars.push_back({ seg, lane });
-    }
-
-    for (int lane = -1; lane <= 1; lane++) {
-        if ((int)(hash32(h ^ (lane + 9) * 999u) % 100) < 30) {
-            bool blocked = false;
-            for (auto &cc : cars)
-                if (cc.seg == seg && cc.lane == lane)
-                    blocked = true;
-            if (!blocked)
-                coins.push_back({ seg, lane, false });
-        }
-    }
+    lastCpu = cpu;
+    lastWallMs = wallMs;
+    chargedMode = mode;
 }
 
-void resetGame() {
-
-    mode = PLAYING;
-
-    distanceScore = 0;
-    coinScore = 0;
-    currentSegment = 0;
-    roadOffset = 0.0f;
-
-    playerX = 0.0f;
-    playerY = 0.5f;
-    currentLane = 0;
-    targetX = 0.0f;
-
-    isJumping = false;
-    velY = 0.0f;
-    windmillAngle = 0.0f;
+void printCpuReport() {
 
-    cars.clear();
-    coins.clear();
-
-    for (long s = 5; s < visibleSegments + 60; s++)
-        spawn(s);
+    std::printf("CPU time per minute of wall time:\n");
+    for (int m = 0; m < 5; m++)
+        if (modeWallSeconds[m] > 1.0)
+            std::printf("  %-10s %6.2f s  (over %.1f min)\n", modeNames[m],
+                        modeCpuSeconds[m] * 60.0 / modeWallSeconds[m],
+                        modeWallSeconds[m] / 60.0);
 }
 
 /* ========================================================================
-   DRAW WORLD (ALL SCENERY PRESERVED)
+   CAPTURE
+   ========================================================================
+   C starts and stops a take; --capture=FORMAT starts one at launch.
+   Takes are numbered: capture_1.y4m, capture_2.y4m, ... (png: one
+   capture_1_00000.png per frame). A take records every tick, so the
+   idle screens are redrawn while it runs, and ends on a resize.
    ======================================================================== */
 
-void drawWorld() {
-
-    glPushMatrix();
-    glTranslatef(0, 0, roadOffset);
-
-    for (int i = -1; i < visibleSegments; i++) {
-
-        long seg = currentSegment + i;
-
-        float zn = -i * segmentLength;
-        float zf = -(i + 1) * segmentLength;
-        float zm = (zn + zf) * 0.5f;
-
-        glColor3f(0.25f, 0.25f, 0.25f);
-        glBegin(GL_QUADS);
-        glVertex3f(-roadHalfWidth, 0, zn);
-        glVertex3f( roadHalfWidth, 0, zn);
-        glVertex3f( roadHalfWidth, 0, zf);
-        glVertex3f(-roadHalfWidth, 0, zf);
-        glEnd();
-
-        if (i % 2 == 0) {
-            glDisable(GL_LIGHTING);
-            glColor3f(1, 1, 0);
-            drawLineDDA(-1.0f, 0.02f, zn, -1.0f, 0.02f, zf);
-            drawLineDDA( 1.0f, 0.02f, zn,  1.0f, 0.02f, zf);
-            glEnable(GL_LIGHTING);
-        }
-
-        glColor3f(0.1f, 0.6f, 0.1f);
-        glBegin(GL_QUADS);
-        glVertex3f(-50.0f, -0.1f, zn);
-        glVertex3f(-roadHalfWidth, -0.1f, zn);
-        glVertex3f(-roadHalfWidth, -0.1f, zf);
-        glVertex3f(-50.0f, -0.1f, zf);
-
-        glVertex3f(roadHalfWidth, -0.1f, zn);
-        glVertex3f(50.0f, -0.1f, zn);
-        glVertex3f(50.0f, -0.1f, zf);
-        glVertex3f(roadHalfWidth, -0.1f, zf);
-        glEnd();
-
-        uint32_t h = hash32((uint32_t)seg ^ 0x9e3779b9U);
-
-        if ((h % 10) > 6)
-            drawTree( roadHalfWidth + 3.0f + (h % 5), zm);
-
-        if (((h >> 4) % 10) > 7)
-            drawTree(-(roadHalfWidth + 3.0f + ((h >> 8) % 5)), zm);
+CaptureFormat captureFormat = CAPTURE_Y4M;
+const char* capturePrefix = "capture";
+bool captureWanted = false;
+int captureTake = 0;
 
-        if (seg % 25 == 0)
-            drawWindmill(roadHalfWidth + 9.0f, zm);
+std::unique_ptr<FrameEncoder> captureEncoder;
+std::unique_ptr<GLFrameCapture> glCapture;
+std::string capturePath;
 
-        if (seg % 17 == 0)
-            drawCartoonHouse(-(roadHalfWidth + 12.0f), zm);
+void startCapture() {
 
-        if (seg % 23 == 0)
-            drawCartoonHouse(roadHalfWidth + 12.0f, zm);
+    static const char* const extensions[] = { ".rgb", ".y4m", "" };
 
-        if (seg % 11 == 0)
-            drawCartoonCharacter(-(roadHalfWidth + 6.0f), zm);
+    capturePath = std::string(capturePrefix) + "_" +
+                  std::to_string(++captureTake) + extensions[captureFormat];
+    captureEncoder.reset(new FrameEncoder(captureFormat, capturePath,
+                                          glutGet(GLUT_WINDOW_WIDTH),
+                                          glutGet(GLUT_WINDOW_HEIGHT)));
+    glCapture.reset(new GLFrameCapture(*captureEncoder));
+}
 
-        if (seg % 13 == 0)
-            drawCartoonCharacter(roadHalfWidth + 6.0f, zm);
-    }
+void stopCapture() {
 
-    for (auto &c : cars) {
-        float z = segmentZ(c.seg);
-        if (z > -160 && z < 10)
-            drawCar(laneX(c.lane), z);
-    }
-
-    for (auto &cn : coins) {
-        if (!cn.collected) {
-            float z = segmentZ(cn.seg);
-            if (z > -160 && z < 10)
-                drawCoin(laneX(cn.lane), z);
-        }
-    }
+    captureWanted = false;
+    if (!glCapture)
+        return;
 
-    glPopMatrix();
+    long frames = glCapture->frames();
+    double overhead = glCapture->overheadSeconds();
+    bool pbos = glCapture->usingPBOs();
+
+    glCapture.reset();          /* flushes the frames still in flight */
+    captureEncoder->finish();
+    CaptureStats s = captureEncoder->stats();
+    captureEncoder.reset();
+
+    std::printf("%s: %ld frames, %ld written, %ld dropped, "
+                "%.3f ms per frame on the render thread (%s), "
+                "%.3f ms per frame encoding\n",
+                capturePath.c_str(), frames, s.written, s.dropped,
+                frames ? overhead * 1000.0 / frames : 0.0,
+                pbos ? "PBO ring" : "blocking glReadPixels",
+                s.written ? s.encodeSeconds * 1000.0 / s.written : 0.0);
 }
 
 /* ========================================================================
-   UPDATE LOOP (DIFFICULTY + COLLISION FIX + DAY CYCLE)
+   UPDATE LOOP (GLUT TIMER)
    ======================================================================== */
 
 void update(int) {
 
-    if (mode == COUNTDOWN) {
-        countdownValue -= 0.016f;
-        if (countdownValue <= 0)
-            mode = PLAYING;
-    }
-
-    if (mode == PLAYING) {
-
-        distanceScore++;
-        windmillAngle += 2.0f;
-
-        scrollSpeed =
-            std::min(maxScrollSpeed,
-                     baseScrollSpeed +
-                     distanceScore * difficultyFactor);
+    chargeTime();
+    tickGame();
 
-        laneSpeed = 0.25f + scrollSpeed * 0.4f;
+    if (mode == PLAYING && playerCount == 1)
+        recordRewind();
 
-        roadOffset += scrollSpeed;
+    uint64_t stamp = sceneStamp();
+    Overlay overlay;
+    buildOverlay(overlay);
 
-        if (roadOffset > segmentLength) {
-            roadOffset -= segmentLength;
-            currentSegment++;
-            spawn(currentSegment + visibleSegments + 40);
-        }
-
-        dayCycle += 0.0005f;
-        if (dayCycle > 6.283f)
-            dayCycle = 0.0f;
-
-        if (isJumping) {
-            playerY += velY;
-            velY -= GRAVITY;
-            if (playerY <= 0.5f) {
-                playerY = 0.5f;
-                isJumping = false;
-                velY = 0.0f;
-            }
-        }
-
-        targetX = currentLane * laneWidth;
-
-        if (playerX < targetX)
-            playerX = std::min(targetX, playerX + laneSpeed);
-        else if (playerX > targetX)
-            playerX = std::max(targetX, playerX - laneSpeed);
-
-        for (auto &c : cars) {
-            if (c.lane == currentLane &&
-                std::abs(segmentZ(c.seg) - (-roadOffset)) < 0.8f &&
-                playerY <= 0.75f) {
-                mode = GAMEOVER;
-                saveHighScore();
-            }
-        }
-
-        for (auto &cn : coins) {
-            if (!cn.collected &&
-                cn.lane == currentLane &&
-                std::abs(segmentZ(cn.seg) - (-roadOffset)) < 0.8f) {
-                cn.collected = true;
-                coinScore++;
-            }
-        }
-    }
+    if (captureWanted || !frameShown || stamp != shownStamp)
+        glutPostRedisplay();
+    else if (std::memcmp(&overlay, &shownOverlay, sizeof(overlay)) &&
+             !redrawOverlay(overlay, stamp))
+        glutPostRedisplay();
 
-    glutPostRedisplay();
     glutTimerFunc(16, update, 0);
 }
 
 void display() {
 
-    int h = glutGet(GLUT_WINDOW_HEIGHT);
-
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-
-    gluLookAt(0.0, 4.0, 6.0,
-              0.0, 0.0, -8.0,
-              0.0, 1.0, 0.0);
-
-    GLfloat lightPos[] = {30.0f, 60.0f, 30.0f, 1.0f};
-    glLightfv(GL_LIGHT0, GL_POSITION, lightPos);
-
-    drawAttractiveBackground();
-
-    if (mode == MENU) {
-
-        drawCenteredText("STREET RUNNER", h * 0.7f, 1,1,1);
-        drawCenteredText("Press ENTER to Start Game", h * 0.55f, 1,1,1);
-        drawCenteredText("Controls: A/D move, SPACE jump, ESC pause", h * 0.45f, 1,1,1);
-        drawCenteredText("Developed by Nasif Abdullah", h * 0.35f, 1,1,1);
-
-    }
-    else {
-
-        drawWorld();
-        drawRobot();
-
-        /* HUD */
+    uint64_t stamp = sceneStamp();
+    Overlay overlay;
+    buildOverlay(overlay);
 
-        char s1[64], s2[64], s3[64];
+    glRenderer.clear();
+    if (playerCount > 1)
+        drawSplitScene(glRenderer, playerCount,
+                       glutGet(GLUT_WINDOW_WIDTH),
+                       glutGet(GLUT_WINDOW_HEIGHT));
+    else
+        drawScene(glRenderer);
 
-        std::snprintf(s1, sizeof(s1), "Distance: %ld", distanceScore);
-        std::snprintf(s2, sizeof(s2), "Coins: %ld", coinScore);
-        std::snprintf(s3, sizeof(s3), "High Score: %ld", highScore);
+    if (mode != PLAYING)
+        saveSceneCopy(stamp);
 
-        drawText(s1, 20, h - 50, 1,1,1);
-        drawText(s2, 20, h - 80, 1,1,0);
-        drawText(s3, 20, h - 110, 0,1,1);
+    drawOverlay(overlay);
 
-        /* PAUSE SCREEN */
-
-        if (mode == PAUSED) {
-            drawCenteredText("PAUSED", h * 0.65f, 1,1,1);
-            drawCenteredText("Press ESC to Resume", h * 0.55f, 1,1,0);
-            drawCenteredText("Press Q to Quit", h * 0.45f, 1,0,0);
-        }
-
-        /* COUNTDOWN SCREEN */
-
-        if (mode == COUNTDOWN) {
-            char cStr[8];
-            std::snprintf(cStr, sizeof(cStr), "%d",
-                          (int)ceil(countdownValue));
-
-            drawCenteredText("GET READY", h * 0.65f, 1,1,1);
-            drawCenteredText(cStr, h * 0.55f, 1,1,0);
-        }
-
-        /* GAME OVER SCREEN */
-
-        if (mode == GAMEOVER) {
-            drawCenteredText("GAME OVER", h * 0.6f, 1,0,0);
-            drawCenteredText("Press R to Restart", h * 0.5f, 1,1,1);
-        }
-    }
+    if (captureWanted && !glCapture)
+        startCapture();
+    if (glCapture)
+        glCapture->captureFrame();
 
     glutSwapBuffers();
+
+    frameShown = true;
+    shownStamp = stamp;
+    shownOverlay = overlay;
 }
 
 void reshape(int w, int h) {
 
     glViewport(0, 0, w, h);
+    setSceneProjection(glRenderer);
+    frameShown = false;
+    sceneCopyValid = false;
 
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-
-    gluPerspective(45.0,
-                   (double)w / (double)h,
-                   1.0,
-                   300.0);
-
-    glMatrixMode(GL_MODELVIEW);
+    if (glCapture && (w != captureEncoder->width() ||
+                      h != captureEncoder->height()))
+        stopCapture();
 }
 void keys(unsigned char k, int, int) {
 
+    if (k == 'c' || k == 'C') {
+        if (captureWanted)
+            stopCapture();
+        else
+            captureWanted = true;
+        return;
+    }
+
     if (k == 27) {
         if (mode == PLAYING)
             mode = PAUSED;
@@ -906,21 +509,43 @@ void keys(unsigned char k, int, int) {
     if (mode == GAMEOVER && (k == 'r' || k == 'R'))
         resetGame();
 
+    if (mode == GAMEOVER && (k == 'b' || k == 'B') &&
+        playerCount == 1 && rewindTicks(rewindOnCrash)) {
+        mode = COUNTDOWN;
+        countdownValue = 3.0f;
+    }
+
     if (mode == PLAYING) {
 
-        if ((k == 'a' || k == 'A') && currentLane > -1)
-            currentLane--;
+        if (k == 'a' || k == 'A') steerPlayer(0, -1);
+        if (k == 'd' || k == 'D') steerPlayer(0, 1);
+        if (k == ' ') jumpPlayer(0);
 
-        if ((k == 'd' || k == 'D') && currentLane < 1)
-            currentLane++;
+        if (playerCount > 1) {
+            if (k == 'j' || k == 'J') steerPlayer(1, -1);
+            if (k == 'l' || k == 'L') steerPlayer(1, 1);
+            if (k == 'i' || k == 'I') jumpPlayer(1);
+        }
 
-        if (k == ' ' && !isJumping) {
-            isJumping = true;
-            velY = JUMP_FORCE;
+        if (playerCount > 3) {
+            if (k == '4') steerPlayer(3, -1);
+            if (k == '6') steerPlayer(3, 1);
+            if (k == '8') jumpPlayer(3);
         }
     }
 }
 
+/* Player 3 steers with the arrow keys. */
+void specialKeys(int k, int, int) {
+
+    if (mode != PLAYING || playerCount < 3)
+        return;
+
+    if (k == GLUT_KEY_LEFT)  steerPlayer(2, -1);
+    if (k == GLUT_KEY_RIGHT) steerPlayer(2, 1);
+    if (k == GLUT_KEY_UP)    jumpPlayer(2);
+}
+
 /* ========================================================================
    MAIN
    ======================================================================== */
@@ -928,6 +553,26 @@ void keys(unsigned char k, int, int) {
 int main(int argc, char** argv) {
 
     glutInit(&argc, argv);
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        if (!std::strncmp(a, "--capture=", 10) &&
+            parseCaptureFormat(a + 10, captureFormat))
+            captureWanted = true;
+        else if (!std::strncmp(a, "--capture-out=", 14))
+            capturePrefix = a + 14;
+        else if (!std::strncmp(a, "--players=", 10)) {
+            setPlayerCount(std::atoi(a + 10));
+            setLaneCount(std::max(3, playerCount + 1));
+        }
+        else {
+            std::fprintf(stderr,
+                "usage: %s [--capture=raw|y4m|png] [--capture-out=PREFIX] "
+                "[--players=1..4]\n",
+                argv[0]);
+            return 2;
+        }
+    }
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
     glutInitWindowSize(1920, 1080);
     glutCreateWindow("Street Runner - Full Advanced");
@@ -947,10 +592,18 @@ int main(int argc, char** argv) {
 
     loadHighScore();
 
+    lastCpu = std::clock();
+    lastWallMs = glutGet(GLUT_ELAPSED_TIME);
+    std::atexit(printCpuReport);
+
     glutDisplayFunc(display);
     glutReshapeFunc(reshape);
     glutKeyboardFunc(keys);
+    glutSpecialFunc(specialKeys);
     glutTimerFunc(0, update, 0);
+#ifdef FREEGLUT
+    glutCloseFunc(stopCapture);
+#endif
 
     glutMainLoop();
     return 0;
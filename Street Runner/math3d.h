@@ -0,0 +1,209 @@
+#ifndef STREET_RUNNER_MATH3D_H
+#define STREET_RUNNER_MATH3D_H
+
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define STREET_RUNNER_SSE 1
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define STREET_RUNNER_NEON 1
+#include <arm_neon.h>
+#endif
+
+/* ========================================================================
+   MATRIX HELPERS
+   ========================================================================
+   Column-major 4x4 matrices with the same conventions as the fixed
+   function GL stack (m[col * 4 + row], angles in degrees), so a Mat4
+   can be handed straight to glLoadMatrixf.
+
+   A column (or a Vec4) is one SSE / NEON register: multiply and
+   transform are four column-times-scalar accumulations, with a plain
+   scalar fallback. The types are 16-byte aligned, but loads stay
+   unaligned since containers of Mat4 are not guaranteed to honour
+   that before C++17.
+   ======================================================================== */
+
+struct alignas(16) Vec4 { float x, y, z, w; };
+
+struct alignas(16) Mat4 { float m[16]; };
+
+inline Mat4 mat4Identity() {
+    Mat4 r = {{ 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 }};
+    return r;
+}
+
+inline Mat4 mat4Multiply(const Mat4& a, const Mat4& b) {
+    Mat4 r;
+#if defined(STREET_RUNNER_SSE)
+    __m128 a0 = _mm_loadu_ps(a.m),     a1 = _mm_loadu_ps(a.m + 4);
+    __m128 a2 = _mm_loadu_ps(a.m + 8), a3 = _mm_loadu_ps(a.m + 12);
+    for (int c = 0; c < 4; c++) {
+        const float* bc = b.m + c * 4;
+        __m128 v = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+        v = _mm_add_ps(v, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+        v = _mm_add_ps(v, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+        v = _mm_add_ps(v, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+        _mm_storeu_ps(r.m + c * 4, v);
+    }
+#elif defined(STREET_RUNNER_NEON)
+    float32x4_t a0 = vld1q_f32(a.m),     a1 = vld1q_f32(a.m + 4);
+    float32x4_t a2 = vld1q_f32(a.m + 8), a3 = vld1q_f32(a.m + 12);
+    for (int c = 0; c < 4; c++) {
+        float32x4_t bc = vld1q_f32(b.m + c * 4);
+        float32x4_t v = vmulq_n_f32(a0, vgetq_lane_f32(bc, 0));
+        v = vmlaq_n_f32(v, a1, vgetq_lane_f32(bc, 1));
+        v = vmlaq_n_f32(v, a2, vgetq_lane_f32(bc, 2));
+        v = vmlaq_n_f32(v, a3, vgetq_lane_f32(bc, 3));
+        vst1q_f32(r.m + c * 4, v);
+    }
+#else
+    for (int c = 0; c < 4; c++)
+        for (int row = 0; row < 4; row++)
+            r.m[c * 4 + row] =
+                a.m[0 * 4 + row] * b.m[c * 4 + 0] +
+                a.m[1 * 4 + row] * b.m[c * 4 + 1] +
+                a.m[2 * 4 + row] * b.m[c * 4 + 2] +
+                a.m[3 * 4 + row] * b.m[c * 4 + 3];
+#endif
+    return r;
+}
+
+inline Vec4 mat4Transform(const Mat4& a, float x, float y, float z, float w) {
+    Vec4 r;
+#if defined(STREET_RUNNER_SSE)
+    __m128 v = _mm_mul_ps(_mm_loadu_ps(a.m), _mm_set1_ps(x));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(a.m + 4), _mm_set1_ps(y)));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(a.m + 8), _mm_set1_ps(z)));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(a.m + 12), _mm_set1_ps(w)));
+    _mm_storeu_ps(&r.x, v);
+#elif defined(STREET_RUNNER_NEON)
+    float32x4_t v = vmulq_n_f32(vld1q_f32(a.m), x);
+    v = vmlaq_n_f32(v, vld1q_f32(a.m + 4), y);
+    v = vmlaq_n_f32(v, vld1q_f32(a.m + 8), z);
+    v = vmlaq_n_f32(v, vld1q_f32(a.m + 12), w);
+    vst1q_f32(&r.x, v);
+#else
+    r.x = a.m[0] * x + a.m[4] * y + a.m[8]  * z + a.m[12] * w;
+    r.y = a.m[1] * x + a.m[5] * y + a.m[9]  * z + a.m[13] * w;
+    r.z = a.m[2] * x + a.m[6] * y + a.m[10] * z + a.m[14] * w;
+    r.w = a.m[3] * x + a.m[7] * y + a.m[11] * z + a.m[15] * w;
+#endif
+    return r;
+}
+
+inline Mat4 mat4Translation(float x, float y, float z) {
+    Mat4 r = mat4Identity();
+    r.m[12] = x; r.m[13] = y; r.m[14] = z;
+    return r;
+}
+
+inline Mat4 mat4Scaling(float x, float y, float z) {
+    Mat4 r = mat4Identity();
+    r.m[0] = x; r.m[5] = y; r.m[10] = z;
+    return r;
+}
+
+/* Same as glRotatef: angle in degrees about an arbitrary axis. */
+inline Mat4 mat4Rotation(float angle, float x, float y, float z) {
+
+    float len = std::sqrt(x * x + y * y + z * z);
+    if (len == 0.0f)
+        return mat4Identity();
+    x /= len; y /= len; z /= len;
+
+    float rad = angle * 3.14159265f / 180.0f;
+    float c = std::cos(rad), s = std::sin(rad), t = 1.0f - c;
+
+    Mat4 r = {{
+        t*x*x + c,   t*x*y + s*z, t*x*z - s*y, 0,
+        t*x*y - s*z, t*y*y + c,   t*y*z + s*x, 0,
+        t*x*z + s*y, t*y*z - s*x, t*z*z + c,   0,
+        0,           0,           0,           1
+    }};
+    return r;
+}
+
+inline Mat4 mat4Perspective(float fovy, float aspect, float zn, float zf) {
+    float f = 1.0f / std::tan(fovy * 3.14159265f / 360.0f);
+    Mat4 r = {{
+        f / aspect, 0, 0,                            0,
+        0,          f, 0,                            0,
+        0,          0, (zf + zn) / (zn - zf),       -1,
+        0,          0, 2.0f * zf * zn / (zn - zf),   0
+    }};
+    return r;
+}
+
+inline Mat4 mat4Ortho(float l, float r, float b, float t, float n, float f) {
+    Mat4 o = {{
+        2.0f / (r - l),      0,                   0,                  0,
+        0,                   2.0f / (t - b),      0,                  0,
+        0,                   0,                  -2.0f / (f - n),     0,
+        -(r + l) / (r - l), -(t + b) / (t - b),  -(f + n) / (f - n),  1
+    }};
+    return o;
+}
+
+inline Mat4 mat4LookAt(float ex, float ey, float ez,
+                       float cx, float cy, float cz,
+                       float ux, float uy, float uz) {
+
+    float fx = cx - ex, fy = cy - ey, fz = cz - ez;
+    float fl = std::sqrt(fx * fx + fy * fy + fz * fz);
+    fx /= fl; fy /= fl; fz /= fl;
+
+    float sx = fy * uz - fz * uy;
+    float sy = fz * ux - fx * uz;
+    float sz = fx * uy - fy * ux;
+    float sl = std::sqrt(sx * sx + sy * sy + sz * sz);
+    sx /= sl; sy /= sl; sz /= sl;
+
+    float vx = sy * fz - sz * fy;
+    float vy = sz * fx - sx * fz;
+    float vz = sx * fy - sy * fx;
+
+    Mat4 r = {{
+        sx, vx, -fx, 0,
+        sy, vy, -fy, 0,
+        sz, vz, -fz, 0,
+        0,  0,   0,  1
+    }};
+    return mat4Multiply(r, mat4Translation(-ex, -ey, -ez));
+}
+
+/* ========================================================================
+   BATCHES
+   ======================================================================== */
+
+/* out[i] = translation(x[i], y, z[i]) * local for a batch of objects
+   that share one local transform. Translating on the left only
+   changes the last column, so there is no full multiply per object. */
+inline void mat4TranslateBatch(const Mat4& local,
+                               const float* x, float y, const float* z,
+                               int count, Mat4* out) {
+    const float lw = local.m[15];
+    for (int i = 0; i < count; i++) {
+        Mat4& o = out[i];
+        o = local;
+        o.m[12] += x[i] * lw;
+        o.m[13] += y * lw;
+        o.m[14] += z[i] * lw;
+    }
+}
+
+/* xyz[i] = (m * (p[i], 1)).xyz for count points, e.g. to flatten an
+   instanced point cloud into one array. */
+inline void mat4TransformPoints(const Mat4& m, const float* p, int count,
+                                float* xyz) {
+    for (int i = 0; i < count; i++) {
+        Vec4 v = mat4Transform(m, p[i * 3], p[i * 3 + 1], p[i * 3 + 2], 1.0f);
+        xyz[i * 3]     = v.x;
+        xyz[i * 3 + 1] = v.y;
+        xyz[i * 3 + 2] = v.z;
+    }
+}
+
+#endif
@@ -0,0 +1,181 @@
+#include "meshes.h"
+
+#include <cmath>
+
+namespace {
+
+const float PI = 3.14159265f;
+
+struct V { float x, y, z, nx, ny, nz; };
+
+void push(Mesh& m, const V& v) {
+    m.positions.push_back(v.x);
+    m.positions.push_back(v.y);
+    m.positions.push_back(v.z);
+    m.normals.push_back(v.nx);
+    m.normals.push_back(v.ny);
+    m.normals.push_back(v.nz);
+}
+
+/* Emits a triangle, flipping it if its winding disagrees with the
+   vertex normals, and drops it when degenerate (sphere poles). */
+void addTri(Mesh& m, const V& a, const V& b, const V& c) {
+
+    float ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+    float vx = c.x - a.x, vy = c.y - a.y, vz = c.z - a.z;
+
+    float fx = uy * vz - uz * vy;
+    float fy = uz * vx - ux * vz;
+    float fz = ux * vy - uy * vx;
+
+    if (fx * fx + fy * fy + fz * fz < 1e-14f)
+        return;
+
+    float nx = a.nx + b.nx + c.nx;
+    float ny = a.ny + b.ny + c.ny;
+    float nz = a.nz + b.nz + c.nz;
+
+    push(m, a);
+    if (fx * nx + fy * ny + fz * nz >= 0.0f) { push(m, b); push(m, c); }
+    else                                     { push(m, c); push(m, b); }
+}
+
+void addQuad(Mesh& m, const V& a, const V& b, const V& c, const V& d) {
+    addTri(m, a, b, c);
+    addTri(m, a, c, d);
+}
+
+}
+
+Mesh makeCube(float size) {
+
+    Mesh m;
+    float h = size * 0.5f;
+
+    static const float faces[6][3] = {
+        { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 },
+        { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }
+    };
+
+    for (int f = 0; f < 6; f++) {
+
+        float n[3] = { faces[f][0], faces[f][1], faces[f][2] };
+
+        /* Two axes spanning the face. */
+        float u[3] = { 0, 0, 0 };
+        if (n[0] != 0) u[1] = 1.0f; else u[0] = 1.0f;
+        float w[3] = { n[1] * u[2] - n[2] * u[1],
+                       n[2] * u[0] - n[0] * u[2],
+                       n[0] * u[1] - n[1] * u[0] };
+
+        V c[4];
+        static const float corner[4][2] = {
+            { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 }
+        };
+        for (int k = 0; k < 4; k++) {
+            float a = corner[k][0], b = corner[k][1];
+            c[k].x = h * (n[0] + a * u[0] + b * w[0]);
+            c[k].y = h * (n[1] + a * u[1] + b * w[1]);
+            c[k].z = h * (n[2] + a * u[2] + b * w[2]);
+            c[k].nx = n[0]; c[k].ny = n[1]; c[k].nz = n[2];
+        }
+        addQuad(m, c[0], c[1], c[2], c[3]);
+    }
+    return m;
+}
+
+Mesh makeSphere(float radius, int slices, int stacks) {
+
+    Mesh m;
+
+    auto at = [&](int i, int j) {
+        float theta = PI * i / stacks;
+        float phi = 2.0f * PI * j / slices;
+        V v;
+        v.nx = std::sin(theta) * std::cos(phi);
+        v.ny = std::sin(theta) * std::sin(phi);
+        v.nz = std::cos(theta);
+        v.x = radius * v.nx; v.y = radius * v.ny; v.z = radius * v.nz;
+        return v;
+    };
+
+    for (int i = 0; i < stacks; i++)
+        for (int j = 0; j < slices; j++)
+            addQuad(m, at(i, j), at(i + 1, j), at(i + 1, j + 1), at(i, j + 1));
+
+    return m;
+}
+
+Mesh makeCone(float base, float height, int slices, int stacks) {
+
+    Mesh m;
+    float len = std::sqrt(height * height + base * base);
+
+    auto side = [&](int i, int j) {
+        float t = (float)i / stacks;
+        float phi = 2.0f * PI * j / slices;
+        float c = std::cos(phi), s = std::sin(phi);
+        float r = base * (1.0f - t);
+        V v = { r * c, r * s, height * t,
+                c * height / len, s * height / len, base / len };
+        return v;
+    };
+
+    for (int i = 0; i < stacks; i++)
+        for (int j = 0; j < slices; j++)
+            addQuad(m, side(i, j), side(i, j + 1),
+                       side(i + 1, j + 1), side(i + 1, j));
+
+    V centre = { 0, 0, 0, 0, 0, -1 };
+    for (int j = 0; j < slices; j++) {
+        V a = side(0, j), b = side(0, j + 1);
+        a.nx = a.ny = 0; a.nz = -1;
+        b.nx = b.ny = 0; b.nz = -1;
+        addTri(m, centre, a, b);
+    }
+    return m;
+}
+
+Mesh makeCylinder(float base, float top, float height,
+                  int slices, int stacks) {
+
+    Mesh m;
+    float slope = (base - top) / height;
+    float len = std::sqrt(1.0f + slope * slope);
+
+    auto at = [&](int i, int j) {
+        float t = (float)i / stacks;
+        float phi = 2.0f * PI * j / slices;
+        float c = std::cos(phi), s = std::sin(phi);
+        float r = base + (top - base) * t;
+        V v = { r * c, r * s, height * t, c / len, s / len, slope / len };
+        return v;
+    };
+
+    for (int i = 0; i < stacks; i++)
+        for (int j = 0; j < slices; j++)
+            addQuad(m, at(i, j), at(i, j + 1), at(i + 1, j + 1), at(i + 1, j));
+
+    return m;
+}
+
+Mesh makeTorus(float inner, float outer, int sides, int rings) {
+
+    Mesh m;
+
+    auto at = [&](int i, int j) {
+        float u = 2.0f * PI * i / rings;
+        float v = 2.0f * PI * j / sides;
+        float cu = std::cos(u), su = std::sin(u);
+        float cv = std::cos(v), sv = std::sin(v);
+        float r = outer + inner * cv;
+        V p = { r * cu, r * su, inner * sv, cv * cu, cv * su, sv };
+        return p;
+    };
+
+    for (int i = 0; i < rings; i++)
+        for (int j = 0; j < sides; j++)
+            addQuad(m, at(i, j), at(i + 1, j), at(i + 1, j + 1), at(i, j + 1));
+
+    return m;
+}
@@ -0,0 +1,29 @@
+#ifndef STREET_RUNNER_MESHES_H
+#define STREET_RUNNER_MESHES_H
+
+#include <vector>
+
+/* ========================================================================
+   SOLID MESHES
+   ========================================================================
+   Triangle-list versions of the GLUT/GLU solids the scene uses, with the
+   same placement conventions (cone and cylinder along +z from z = 0,
+   torus in the xy plane). Triangles wind counter-clockwise seen from
+   outside, and every vertex carries its normal.
+   ======================================================================== */
+
+struct Mesh {
+    std::vector<float> positions;   /* xyz per vertex, 3 vertices per tri */
+    std::vector<float> normals;     /* xyz per vertex */
+
+    int vertexCount() const { return (int)(positions.size() / 3); }
+};
+
+Mesh makeCube(float size);
+Mesh makeSphere(float radius, int slices, int stacks);
+Mesh makeCone(float base, float height, int slices, int stacks);
+Mesh makeCylinder(float base, float top, float height,
+                  int slices, int stacks);
+Mesh makeTorus(float inner, float outer, int sides, int rings);
+
+#endif
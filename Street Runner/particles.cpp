@@ -0,0 +1,140 @@
+#include "particles.h"
+
+#include <algorithm>
+
+ParticlePool particles;
+
+namespace {
+
+uint32_t particleRng = 0x2545F491u;
+
+/* xorshift32, [0, 1) */
+inline float frand() {
+    particleRng ^= particleRng << 13;
+    particleRng ^= particleRng >> 17;
+    particleRng ^= particleRng << 5;
+    return (particleRng >> 8) * (1.0f / 16777216.0f);
+}
+
+inline float frange(float lo, float hi) { return lo + (hi - lo) * frand(); }
+
+void spawnOne(float x, float y, float z,
+              float vx, float vy, float vz,
+              float gravity, float life,
+              float r, float g, float b) {
+
+    ParticlePool& p = particles;
+    if (p.count >= maxParticles)
+        return;
+
+    int i = p.count++;
+    p.x[i] = x;   p.y[i] = y;   p.z[i] = z;
+    p.vx[i] = vx; p.vy[i] = vy; p.vz[i] = vz;
+    p.gravity[i] = gravity;
+    p.life[i] = life;
+    p.fade[i] = 1.0f / life;
+    p.r[i] = r;   p.g[i] = g;   p.b[i] = b;
+}
+
+}
+
+void clearParticles() {
+    particles.count = 0;
+}
+
+void emitCoinSparkle(float x, float y, float z) {
+    for (int k = 0; k < 48; k++) {
+        float t = frand();
+        spawnOne(x, y, z,
+                 frange(-0.06f, 0.06f), frange(0.02f, 0.12f),
+                 frange(-0.06f, 0.06f),
+                 0.004f, frange(25.0f, 45.0f),
+                 1.0f, 0.75f + 0.25f * t, 0.2f * t);
+    }
+}
+
+void emitCrashDebris(float x, float y, float z) {
+    for (int k = 0; k < 256; k++) {
+        bool metal = frand() < 0.5f;
+        spawnOne(x + frange(-0.4f, 0.4f), y + frange(0.0f, 0.8f), z,
+                 frange(-0.15f, 0.15f), frange(0.05f, 0.3f),
+                 frange(-0.1f, 0.2f),
+                 0.015f, frange(40.0f, 90.0f),
+                 metal ? 0.6f : 0.85f,
+                 metal ? 0.6f : 0.1f,
+                 metal ? 0.6f : 0.1f);
+    }
+}
+
+void emitRunDust(float x, float z) {
+    for (int k = 0; k < 2; k++)
+        spawnOne(x + frange(-0.2f, 0.2f), 0.05f, z + 0.2f,
+                 frange(-0.01f, 0.01f), frange(0.005f, 0.02f),
+                 frange(0.0f, 0.02f),
+                 0.0005f, frange(15.0f, 30.0f),
+                 0.55f, 0.5f, 0.45f);
+}
+
+void updateParticles(float groundSpeed) {
+
+    ParticlePool& p = particles;
+    const int n = p.count;
+
+    float* __restrict x = p.x;
+    float* __restrict y = p.y;
+    float* __restrict z = p.z;
+    float* __restrict vx = p.vx;
+    float* __restrict vy = p.vy;
+    const float* __restrict vz = p.vz;
+    const float* __restrict gravity = p.gravity;
+    float* __restrict life = p.life;
+
+    /* Branch-free integration; the ground bounce is a clamp plus a
+       damped reflection of vy. */
+    for (int i = 0; i < n; i++) {
+        vy[i] -= gravity[i];
+        x[i] += vx[i];
+        y[i] += vy[i];
+        z[i] += vz[i] + groundSpeed;
+        float below = y[i] < 0.0f ? 1.0f : 0.0f;
+        y[i] = std::max(y[i], 0.0f);
+        vy[i] += below * (-1.4f * vy[i]);
+        vx[i] *= 1.0f - 0.1f * below;
+        life[i] -= 1.0f;
+    }
+
+    /* Swap-remove the dead: the work is proportional to deaths, not to
+       the pool size. Draw order does not matter for points. */
+    int live = n;
+    for (int i = 0; i < live; ) {
+        if (life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        int j = --live;
+        p.x[i] = p.x[j];   p.y[i] = p.y[j];   p.z[i] = p.z[j];
+        p.vx[i] = p.vx[j]; p.vy[i] = p.vy[j]; p.vz[i] = p.vz[j];
+        p.gravity[i] = p.gravity[j];
+        p.life[i] = p.life[j];
+        p.fade[i] = p.fade[j];
+        p.r[i] = p.r[j];   p.g[i] = p.g[j];   p.b[i] = p.b[j];
+    }
+    p.count = live;
+}
+
+int packParticles(float* xyz, float* rgba) {
+
+    const ParticlePool& p = particles;
+    const int n = p.count;
+
+    for (int i = 0; i < n; i++) {
+        xyz[i * 3 + 0] = p.x[i];
+        xyz[i * 3 + 1] = p.y[i];
+        xyz[i * 3 + 2] = p.z[i];
+        rgba[i * 4 + 0] = p.r[i];
+        rgba[i * 4 + 1] = p.g[i];
+        rgba[i * 4 + 2] = p.b[i];
+        rgba[i * 4 + 3] = std::min(1.0f, p.life[i] * p.fade[i] * 2.0f);
+    }
+    return n;
+}
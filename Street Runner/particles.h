@@ -0,0 +1,54 @@
+#ifndef STREET_RUNNER_PARTICLES_H
+#define STREET_RUNNER_PARTICLES_H
+
+#include <cstdint>
+
+/* ========================================================================
+   PARTICLES
+   ========================================================================
+   Coin sparkles, crash debris and running dust. Particles live in a
+   fixed-capacity structure-of-arrays pool: spawning past capacity drops
+   the new particles, nothing is allocated per particle, and the update
+   is a set of flat loops over the arrays that the compiler vectorizes.
+
+   Positions are in the robot's frame (the one drawRobot() uses), with
+   +z towards the camera; anything left on the road drifts back at
+   scrollSpeed.
+   ======================================================================== */
+
+const int maxParticles = 8192;
+
+struct ParticlePool {
+    int count;
+
+    alignas(32) float x[maxParticles];
+    alignas(32) float y[maxParticles];
+    alignas(32) float z[maxParticles];
+    alignas(32) float vx[maxParticles];
+    alignas(32) float vy[maxParticles];
+    alignas(32) float vz[maxParticles];
+    alignas(32) float gravity[maxParticles];
+    alignas(32) float life[maxParticles];      /* ticks left */
+    alignas(32) float fade[maxParticles];      /* 1 / starting life */
+    alignas(32) float r[maxParticles];
+    alignas(32) float g[maxParticles];
+    alignas(32) float b[maxParticles];
+};
+
+extern ParticlePool particles;
+
+void clearParticles();
+
+void emitCoinSparkle(float x, float y, float z);
+void emitCrashDebris(float x, float y, float z);
+void emitRunDust(float x, float z);
+
+/* One 16 ms step: integrate, fade and compact out dead particles.
+   groundSpeed is how far the road moved this tick. */
+void updateParticles(float groundSpeed);
+
+/* Fills interleaved xyz / rgba arrays (alpha fades with life) for one
+   batched point draw; returns the number of particles written. */
+int packParticles(float* xyz, float* rgba);
+
+#endif
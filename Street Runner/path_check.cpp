@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "game.h"
+#include "traffic.h"
+
+/* ========================================================================
+   PATH CHECK
+   ========================================================================
+   Plays the road with nobody on it and checks, tick by tick against the
+   live traffic, that a runner could have made it through:
+
+       street_runner_pathcheck --lanes=3 --traffic=100 --ticks=20000
+
+   The runner is parked off the road so tickGame() runs the traffic as
+   it would in a game. Every tick the lanes a car would hit are worked
+   out the way carsHittingPlayer() does it, and a search follows every
+   lane, jump phase and lane-change cooldown a runner starting in the
+   middle lane could be in. A lane change takes the ticks the robot
+   needs to get there at laneSpeed; a jump is JUMP_FORCE and GRAVITY
+   stepped like tickPlayer() does.
+
+   Exits with 1 if no runner survives. Walls, ticks on which every lane
+   is blocked, are reported too: a short one can be jumped.
+   --speed=V holds the scroll speed at V instead of ramping it up.
+   --slowmo has the runner take every slow-motion power-up as it passes
+   one, in whichever lane, so the road is checked slowed down as well.
+   ======================================================================== */
+
+namespace {
+
+const int maxPhase = 40;
+const int maxCooldown = 16;
+
+/* Runner height at each tick of a jump; the jump ends on the tick the
+   runner is back on the ground, landTick. */
+float jumpY[maxPhase + 1];
+int landTick;
+
+void stepJump() {
+    float y = 0.5f, v = JUMP_FORCE;
+    jumpY[0] = y;
+    for (landTick = 1; landTick < maxPhase; landTick++) {
+        y += v;
+        v -= GRAVITY;
+        jumpY[landTick] = y;
+        if (y <= 0.5f)
+            break;
+    }
+}
+
+uint64_t allLanes() {
+    return laneCount >= 64 ? ~0ULL : (1ULL << laneCount) - 1;
+}
+
+/* Lanes a runner on the ground would be hit in on this tick. */
+uint64_t blockedLanes() {
+
+    const TrafficPool& t = traffic;
+    uint64_t blocked = 0;
+
+    for (int i = 0; i < t.count; i++) {
+        if (std::fabs(t.z[i] + roadOffset) >= carHitReach)
+            continue;
+        for (int lane = 0; lane < laneCount; lane++)
+            if (std::fabs(t.x[i] - laneX(lane)) < laneWidth * 0.5f)
+                blocked |= 1ULL << lane;
+    }
+    return blocked;
+}
+
+/* Slow motion from the power-up the runner is passing, if any; the
+   same pickup box checkCollisions() uses, lane aside. */
+void takeSlowMotion() {
+    for (PowerUp& pu : powerUps)
+        if (pu.kind == POWERUP_SLOWMO && !pu.collected &&
+            std::fabs(segmentZ(pu.seg) + roadOffset) < 0.8f) {
+            pu.collected = true;
+            slowMotionTime = slowMotionDuration;
+        }
+}
+
+/* Player 0 is the active one between ticks. */
+void parkRunner() {
+    currentLane = -1000;
+    playerX = targetX = laneX(currentLane);
+}
+
+}
+
+int main(int argc, char** argv) {
+
+    int lanes = 3;
+    long ticks = 20000;
+    float speed = 0.0f;
+    bool slowmo = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        if      (!std::strncmp(a, "--lanes=", 8))   lanes = std::atoi(a + 8);
+        else if (!std::strncmp(a, "--traffic=", 10)) carDensity = std::atoi(a + 10);
+        else if (!std::strncmp(a, "--ticks=", 8))   ticks = std::atol(a + 8);
+        else if (!std::strncmp(a, "--speed=", 8))   speed = (float)std::atof(a + 8);
+        else if (!std::strcmp(a, "--slowmo"))        slowmo = true;
+        else {
+            std::fprintf(stderr,
+                "usage: %s [--lanes=N] [--traffic=PERCENT] [--ticks=N]\n"
+                "          [--speed=V] [--slowmo]\n",
+                argv[0]);
+            return 2;
+        }
+    }
+
+    if (speed > 0.0f)
+        baseScrollSpeed = maxScrollSpeed = speed;
+
+    highScoreFile = nullptr;
+    setLaneCount(lanes);
+    setPlayerCount(1);
+    resetGame();
+    stepJump();
+
+    /* alive[phase][cooldown]: lanes a runner can be in after the tick,
+       phase ticks into a jump (0 on the ground) and cooldown ticks
+       before it can change lane again. */
+    static uint64_t alive[maxPhase][maxCooldown];
+    static uint64_t next[maxPhase][maxCooldown];
+    alive[0][0] = 1ULL << runners[0].lane;
+
+    const uint64_t all = allLanes();
+    long walls = 0, wallRun = 0, longestWall = 0, diedAt = -1;
+    long carsSeen = 0, slowTicks = 0;
+
+    parkRunner();
+
+    for (long tick = 1; tick <= ticks && diedAt < 0; tick++) {
+
+        int cooldown = (int)std::ceil(laneWidth / laneSpeed);
+        cooldown = std::min(std::max(cooldown, 1), maxCooldown);
+
+        tickGame();
+        parkRunner();
+        if (slowmo)
+            takeSlowMotion();
+        slowTicks += slowMotionTime > 0.0f;
+
+        uint64_t blocked = blockedLanes();
+        carsSeen += traffic.count;
+
+        if (blocked == all) {
+            walls++;
+            longestWall = std::max(longestWall, ++wallRun);
+        } else {
+            wallRun = 0;
+        }
+
+        std::memset(next, 0, sizeof(next));
+        bool any = false;
+
+        for (int p = 0; p < landTick; p++)
+            for (int c = 0; c < maxCooldown; c++) {
+                uint64_t m = alive[p][c];
+                if (!m)
+                    continue;
+
+                /* Jump or not, then where the tick leaves the runner. */
+                for (int jump = 0; jump < 2; jump++) {
+                    if (jump && p)
+                        break;
+                    int q = p ? p + 1 : jump;
+                    bool exposed = jumpY[q] <= carRoofHeight;
+                    if (q == landTick)
+                        q = 0;
+
+                    uint64_t stay = exposed ? m & ~blocked : m;
+                    int c1 = std::max(c - 1, 0);
+                    if (stay) {
+                        next[q][c1] |= stay;
+                        any = true;
+                    }
+
+                    if (c == 0) {
+                        uint64_t moved = ((m << 1) | (m >> 1)) & all;
+                        if (exposed)
+                            moved &= ~blocked;
+                        if (moved) {
+                            next[q][cooldown - 1] |= moved;
+                            any = true;
+                        }
+                    }
+                }
+            }
+
+        std::memcpy(alive, next, sizeof(alive));
+        if (!any)
+            diedAt = tick;
+    }
+
+    std::printf("%d lanes, %d%% traffic: %ld ticks, %.0f cars on average\n",
+                laneCount, carDensity, diedAt < 0 ? ticks : diedAt,
+                (double)carsSeen / (diedAt < 0 ? ticks : diedAt));
+    std::printf("walls: %ld ticks, longest %ld\n", walls, longestWall);
+    if (slowmo)
+        std::printf("slow motion: %ld ticks\n", slowTicks);
+    std::printf("cars moved to another lane: %ld, left out: %ld\n",
+                movedCars, droppedCars);
+
+    if (diedAt >= 0) {
+        std::printf("no way through at tick %ld\n", diedAt);
+        return 1;
+    }
+    std::printf("a runner can get through\n");
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "poses.h"
+#include "math3d.h"
+#include "meshes.h"
+#include "algorithms.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+/* ========================================================================
+   ROBOT
+   ======================================================================== */
+
+/* Appends mesh m transformed by xf; normals go through the cofactor
+   matrix of xf's upper 3x3 and are renormalised. */
+void addPart(PoseMesh& out, const Mesh& m, const Mat4& xf,
+             float r, float g, float b) {
+
+    const float* x = xf.m;
+    float a = x[0], bb = x[4], c = x[8];
+    float d = x[1], e = x[5], f = x[9];
+    float gg = x[2], h = x[6], i = x[10];
+    float n[9] = {
+        e * i - f * h,  f * gg - d * i, d * h - e * gg,
+        c * h - bb * i, a * i - c * gg, bb * gg - a * h,
+        bb * f - c * e, c * d - a * f,  a * e - bb * d
+    };
+
+    const float* p = m.positions.data();
+    const float* q = m.normals.data();
+
+    for (int k = 0; k < m.vertexCount(); k++) {
+
+        Vec4 v = mat4Transform(xf, p[k * 3], p[k * 3 + 1], p[k * 3 + 2], 1.0f);
+        out.positions.push_back(v.x);
+        out.positions.push_back(v.y);
+        out.positions.push_back(v.z);
+
+        float nx = n[0] * q[k * 3] + n[1] * q[k * 3 + 1] + n[2] * q[k * 3 + 2];
+        float ny = n[3] * q[k * 3] + n[4] * q[k * 3 + 1] + n[5] * q[k * 3 + 2];
+        float nz = n[6] * q[k * 3] + n[7] * q[k * 3 + 1] + n[8] * q[k * 3 + 2];
+        float len = std::sqrt(nx * nx + ny * ny + nz * nz);
+        float s = len > 0.0f ? 1.0f / len : 0.0f;
+        out.normals.push_back(nx * s);
+        out.normals.push_back(ny * s);
+        out.normals.push_back(nz * s);
+
+        out.colors.push_back(r);
+        out.colors.push_back(g);
+        out.colors.push_back(b);
+        out.colors.push_back(1.0f);
+    }
+}
+
+/* Same limbs, angles and colours drawRobot() used to issue one by one. */
+void bakeRobot(PoseMesh& out, float runAnim) {
+
+    static const Mesh cube = makeCube(1.0f);
+    static const Mesh head = makeSphere(0.35f, 12, 12);
+
+    const Mat4 root = mat4Scaling(0.65f, 0.65f, 0.65f);
+
+    addPart(out, cube,
+            mat4Multiply(root, mat4Scaling(0.6f, 0.8f, 0.4f)),
+            0.2f, 0.2f, 0.8f);
+
+    addPart(out, head,
+            mat4Multiply(root, mat4Translation(0.0f, 0.7f, 0.0f)),
+            0.9f, 0.9f, 0.9f);
+
+    for (int side = -1; side <= 1; side += 2) {
+
+        Mat4 arm = mat4Multiply(root, mat4Translation(0.4f * side, 0.2f, 0.0f));
+        arm = mat4Multiply(arm, mat4Rotation(side * runAnim, 1, 0, 0));
+        arm = mat4Multiply(arm, mat4Translation(0.0f, -0.35f, 0.0f));
+        arm = mat4Multiply(arm, mat4Scaling(0.15f, 0.7f, 0.15f));
+        addPart(out, cube, arm, 0.6f, 0.6f, 0.6f);
+
+        Mat4 leg = mat4Multiply(root, mat4Translation(0.15f * side, -0.55f, 0.0f));
+        leg = mat4Multiply(leg, mat4Rotation(-side * runAnim, 1, 0, 0));
+        leg = mat4Multiply(leg, mat4Translation(0.0f, -0.45f, 0.0f));
+        leg = mat4Multiply(leg, mat4Scaling(0.2f, 0.9f, 0.2f));
+        addPart(out, cube, leg, 0.2f, 0.2f, 0.6f);
+    }
+}
+
+/* ========================================================================
+   CARTOON CHARACTER
+   ======================================================================== */
+
+/* algorithms.h sink that records coloured points, offset and scaled
+   into the character's frame. */
+struct PosePointSink {
+    PosePoints& out;
+    float r, g, b;
+    float dx, dy;
+
+    void begin() {}
+    void end() {}
+    void vertex(float x, float y, float z) {
+        out.positions.push_back((x + dx) * 1.5f);
+        out.positions.push_back((y + dy) * 1.5f);
+        out.positions.push_back(z * 1.5f);
+        out.colors.push_back(r);
+        out.colors.push_back(g);
+        out.colors.push_back(b);
+        out.colors.push_back(1.0f);
+    }
+};
+
+void bakeCharacter(PosePoints& out, float wave) {
+
+    PosePointSink head = { out, 1.0f, 0.8f, 0.6f, 0.0f, 0.6f };
+    emitFilledMidpointCircle(head, 8, 0.02f);
+
+    PosePointSink body = { out, 0.0f, 0.8f, 0.0f, 0.0f, 0.0f };
+    emitLineDDA(body, 0, 0.6f, 0, 0, 0.2f, 0);
+    emitLineDDA(body, 0, 0.5f, 0, -0.3f, 0.4f, 0);
+    emitLineDDA(body, 0, 0.5f, 0,  0.3f, 0.4f + wave, 0);
+
+    PosePointSink legs = { out, 0.0f, 0.0f, 0.8f, 0.0f, 0.0f };
+    emitLineDDA(legs, 0, 0.2f, 0, -0.2f, -0.5f, 0);
+    emitLineDDA(legs, 0, 0.2f, 0,  0.2f, -0.5f, 0);
+}
+
+inline int nearestSample(float v, float lo, float hi, int count) {
+    int k = (int)std::lround((v - lo) / (hi - lo) * (count - 1));
+    return std::min(std::max(k, 0), count - 1);
+}
+
+}
+
+const PoseMesh& robotPose(float runAnim) {
+
+    static std::vector<PoseMesh> poses;
+    if (poses.empty()) {
+        poses.resize(robotPoseCount);
+        for (int k = 0; k < robotPoseCount; k++)
+            bakeRobot(poses[k], -30.0f + 60.0f * k / (robotPoseCount - 1));
+    }
+    return poses[nearestSample(runAnim, -30.0f, 30.0f, robotPoseCount)];
+}
+
+const PosePoints& characterPose(float wave) {
+
+    static std::vector<PosePoints> poses;
+    if (poses.empty()) {
+        poses.resize(characterPoseCount);
+        for (int k = 0; k < characterPoseCount; k++)
+            bakeCharacter(poses[k], 0.3f * k / (characterPoseCount - 1));
+    }
+    return poses[nearestSample(wave, 0.0f, 0.3f, characterPoseCount)];
+}
@@ -0,0 +1,42 @@
+#ifndef STREET_RUNNER_POSES_H
+#define STREET_RUNNER_POSES_H
+
+#include <vector>
+
+/* ========================================================================
+   POSE CACHE
+   ========================================================================
+   The robot's run cycle is a function of one angle (runAnim, +-30
+   degrees) and the roadside characters' only moving part is the waving
+   arm. Both are sampled once into tables of pre-transformed geometry,
+   so drawing either is a single array submission instead of a push /
+   transform / solid per limb. Tables are baked on first use.
+
+   Robot poses are lit triangle lists around the body centre (the point
+   drawRobot() translates to). Character poses are the DDA / midpoint
+   circle points in the character's local frame, before its bob.
+   ======================================================================== */
+
+struct PoseMesh {
+    std::vector<float> positions;   /* xyz per vertex, 3 vertices per tri */
+    std::vector<float> normals;     /* xyz per vertex */
+    std::vector<float> colors;      /* rgba per vertex */
+
+    int vertexCount() const { return (int)(positions.size() / 3); }
+};
+
+struct PosePoints {
+    std::vector<float> positions;   /* xyz per point */
+    std::vector<float> colors;      /* rgba per point */
+
+    int count() const { return (int)(positions.size() / 3); }
+};
+
+const int robotPoseCount = 33;       /* runAnim -30 .. +30, ~1.9 deg apart */
+const int characterPoseCount = 16;   /* wave 0 .. 0.3 */
+
+/* Nearest baked pose; inputs outside the sampled range are clamped. */
+const PoseMesh& robotPose(float runAnim);
+const PosePoints& characterPose(float wave);
+
+#endif
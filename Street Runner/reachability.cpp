@@ -0,0 +1,658 @@
+#include "reachability.h"
+#include "game.h"
+#include "traffic.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+/* Rows by road distance: row r is [r, r + 1) * rowLength. The ring
+   holds far more than the road between the runner and the furthest
+   meeting with a car. */
+const float rowLength = 1.0f;
+const int ringRows = 1024;
+const int maxSwitchRows = 8;
+const int maxJumpRows = 24;
+const int lookBack = maxJumpRows + 2;
+
+/* Float error in the car and road positions over a car's approach. */
+const double hitMargin = 0.1;
+
+/* Closest a car is placed to come to another, unless it already is
+   closer in the same lane; then it only never gets closer. A car is
+   never placed closer than carLength, the body scene.cpp draws. */
+const float carGap = 3.0f;
+const float carLength = 2.0f;
+
+/* Free lanes of its segment a car that does not fit is tried in. */
+const int maxMovedLanes = 4;
+
+/* Half the length of the box checkCollisions() picks power-ups up in. */
+const double pickupReach = 0.8;
+
+struct Row {
+    long row;              /* tag; the row is rebuilt on a miss */
+    uint64_t blocked;      /* lanes a car is in as the runner passes */
+    uint64_t reach;        /* lanes the runner can start the row in */
+    uint8_t switchRows;    /* rows a change to the next lane takes */
+    uint8_t jumpShort;     /* rows ahead a jump from here can land in */
+    uint8_t jumpLong;
+    uint8_t jumpLanes;     /* lanes crossed in the air */
+};
+
+Row rows[ringRows];
+long firstRow;             /* reach given, not worked out */
+long sweptTo;              /* reach worked out up to here */
+bool rebuild = false;      /* a snapshot was loaded since */
+
+/* Road slow motion may be on over, from a jump before its pickup on
+   (see slowStretch()); rows reaching into one get no jumps. */
+struct SlowStretch {
+    double from, to;
+};
+
+std::vector<SlowStretch> slowStretches;
+
+/* Ticks into a jump of the first one at or below car roof height, and
+   of the one back on the ground, stepped the way tickPlayer() does. */
+int jumpExposed, jumpLanded;
+
+struct Undo { long row; uint64_t blocked, reach; };
+Undo undo[3 * ringRows];      /* two spans' rows, then the sweep's */
+int undoCount;
+
+uint64_t allLanes() {
+    return laneCount >= 64 ? ~0ULL : (1ULL << laneCount) - 1;
+}
+
+/* Every lane within reach lanes of one in mask. */
+uint64_t widen(uint64_t mask, int reach) {
+    const uint64_t all = allLanes();
+    for (int i = 0; i < reach && mask != all; i++)
+        mask |= (mask << 1) | (mask >> 1);
+    return mask & all;
+}
+
+void stepJump() {
+    float y = 0.5f, v = JUMP_FORCE;
+    jumpExposed = 0;
+    for (int tick = 1; ; tick++) {
+        y += v;
+        v -= GRAVITY;
+        if (!jumpExposed && y <= carRoofHeight)
+            jumpExposed = tick;
+        if (y <= 0.5f) {
+            jumpLanded = tick;
+            return;
+        }
+    }
+}
+
+/* How the runner can leave row r, at the slowest scroll speed it can
+   have there for lane-change cooldowns and jump lengths and the fastest
+   for the ticks spent in each row. */
+void planRow(Row& w, long r) {
+
+    const double start = r * (double)rowLength;
+    const float slow = scrollSpeedAt(start);
+    const int cooldown = (int)std::ceil(laneWidth / laneSpeedFor(slow));
+
+    float fast = scrollSpeedAt(start + maxSwitchRows * rowLength);
+    int ticks = std::max(1, (int)(rowLength / fast));
+    w.switchRows = (uint8_t)std::min((cooldown + ticks - 1) / ticks,
+                                     maxSwitchRows);
+
+    /* Take off in this row, past this row's and the next k - 1 rows'
+       cars, be on the ground again within row k; there has to be a tick
+       to take off on wherever the rows fall. */
+    fast = scrollSpeedAt(start + (maxJumpRows + 1) * rowLength);
+    const double first = jumpExposed * (double)slow;
+    const double landed = jumpLanded * (double)fast;
+
+    w.jumpShort = w.jumpLong = 0;
+    for (int k = 2; k <= maxJumpRows; k++) {
+        double from = std::max(0.0, k * rowLength - first);
+        double to = std::min((double)rowLength,
+                             (k + 1) * rowLength - landed);
+        if (to - from < fast)
+            continue;
+        if (!w.jumpShort)
+            w.jumpShort = (uint8_t)k;
+        w.jumpLong = (uint8_t)k;
+    }
+    w.jumpLanes = (uint8_t)((jumpExposed - 1) / cooldown);
+
+    for (const SlowStretch& s : slowStretches)
+        if (start < s.to && start + rowLength > s.from)
+            w.jumpShort = w.jumpLong = 0;
+}
+
+Row& rowAt(long r) {
+    Row& w = rows[r & (ringRows - 1)];
+    if (w.row != r) {
+        w.row = r;
+        w.blocked = w.reach = 0;
+        planRow(w, r);
+    }
+    return w;
+}
+
+inline uint64_t freeIn(long r) { return allLanes() & ~rowAt(r).blocked; }
+
+inline uint64_t reachOf(long r) {
+    return r >= firstRow && r < sweptTo ? rowAt(r).reach : 0;
+}
+
+uint64_t workOutReach(long r) {
+
+    uint64_t in = reachOf(r - 1);
+
+    uint64_t clear = ~0ULL;
+    for (int m = 1; m <= maxSwitchRows && r - m >= firstRow; m++) {
+        clear &= freeIn(r - m);
+        if (rowAt(r - m).switchRows == m) {
+            uint64_t from = reachOf(r - m);
+            in |= ((from << 1) | (from >> 1)) & clear;
+        }
+    }
+
+    for (int k = 2; k <= maxJumpRows && r - 1 - k >= firstRow; k++) {
+        const Row& a = rowAt(r - 1 - k);
+        if (k >= a.jumpShort && k <= a.jumpLong)
+            in |= widen(reachOf(r - 1 - k), a.jumpLanes) & freeIn(r - 1);
+    }
+
+    return in & freeIn(r);
+}
+
+/* Works the reach out again from row from on, now that rows up to last
+   have new cars in them. Stops once lookBack rows past last come out as
+   before. Rows jumped over have no lane, but no jump or lane change
+   spans lookBack of them: returns false if that many come in a row. */
+bool sweep(long from, long last) {
+
+    long end = std::max(sweptTo, last + lookBack + 1);
+    long same = 0, empty = 0;
+    from = std::max(std::min(from, sweptTo), firstRow + 1);
+
+    while (empty < lookBack && from - empty - 1 > firstRow &&
+           !reachOf(from - empty - 1))
+        empty++;
+
+    for (long r = from; r < end; r++) {
+        Row& w = rowAt(r);
+        uint64_t was = r < sweptTo ? w.reach : ~0ULL;
+        if (r >= sweptTo)
+            sweptTo = r + 1;
+        uint64_t now = workOutReach(r);
+        if (now != was) {
+            undo[undoCount++] = { r, w.blocked, was };
+            w.reach = now;
+            same = 0;
+        } else if (r > last && ++same >= lookBack) {
+            break;
+        }
+        empty = now ? 0 : empty + 1;
+        if (empty >= lookBack)
+            return false;
+    }
+    return true;
+}
+
+/* Road position of the runner, from p, time ticks (at the normal rate)
+   later. */
+double runnerAt(double p, double time) {
+
+    const double v = scrollSpeedAt(p);
+    const double top = maxScrollSpeed;
+    const double a = difficultyFactor;
+    const double ramp = a > 0.0 && v < top ? (top - v) / a : 0.0;
+
+    if (time <= ramp)
+        return p + v * time + a * time * time * 0.5;
+    return p + v * ramp + a * ramp * ramp * 0.5 + top * (time - ramp);
+}
+
+/* Road time until the runner, from p, has closed a gap on something
+   doing speed per tick; false if it never does. */
+bool closeGap(double p, double speed, double gap, double& time) {
+
+    const double v = scrollSpeedAt(p);
+    const double top = maxScrollSpeed;
+    const double a = difficultyFactor;
+
+    if (gap <= 0.0) {
+        time = 0.0;
+        return true;
+    }
+
+    double ramp = a > 0.0 && v < top ? (top - v) / a : 0.0;
+    double closed = (v - speed) * ramp + a * ramp * ramp * 0.5;
+
+    if (gap <= closed) {
+        double d = v - speed;
+        time = 2.0 * gap / (d + std::sqrt(d * d + 2.0 * a * gap));
+        return true;
+    }
+    if (top <= speed)
+        return false;
+
+    time = ramp + (gap - closed) / (top - speed);
+    return true;
+}
+
+/* Road time until car i is dropped behind the camera. */
+double leaveTime(int i) {
+    double time;
+    if (!closeGap(roadDistance(), traffic.speed[i],
+                  cullBehind - (traffic.z[i] + roadOffset), time))
+        return 1e30;
+    return time;
+}
+
+/* Puts back the rows changed since undoCount was cleared. */
+void rollBack(long sweptBefore) {
+    for (int k = undoCount - 1; k >= 0; k--) {
+        Row& w = rowAt(undo[k].row);
+        w.blocked = undo[k].blocked;
+        w.reach = undo[k].reach;
+    }
+    sweptTo = sweptBefore;
+}
+
+/* Adds car i to the rows it is in as the runner passes it; if that
+   leaves the runner no way through, takes it out again and returns
+   false. */
+bool admitCar(int i) {
+
+    const TrafficPool& t = traffic;
+    const double p = roadDistance();
+    const double gap = -(t.z[i] + roadOffset);
+    double timeIn, timeOut;
+
+    if (!closeGap(p, t.speed[i], gap - carHitReach, timeIn))
+        return true;
+    if (!closeGap(p, t.speed[i], gap + carHitReach, timeOut))
+        return false;
+
+    CarSpan spans[2];
+    const int n = carSpans(i, spans);
+    const long runnerRow = (long)std::floor(p / rowLength);
+    long first = LONG_MAX, last = LONG_MIN;
+
+    undoCount = 0;
+    long sweptBefore = sweptTo;
+    bool fits = true;
+
+    for (int k = 0; k < n && fits; k++) {
+        double from = std::max((double)spans[k].from, timeIn);
+        double to = std::min((double)spans[k].to, timeOut);
+        if (from > to)
+            continue;
+
+        long r0 = (long)std::floor((runnerAt(p, from) - hitMargin) /
+                                   rowLength);
+        long r1 = (long)std::floor((runnerAt(p, to) + hitMargin) /
+                                   rowLength);
+        if (r1 + 2 * lookBack >= runnerRow + ringRows) {
+            fits = false;
+            break;
+        }
+        r0 = std::max(r0, firstRow + 1);
+
+        for (long r = r0; r <= r1; r++) {
+            Row& w = rowAt(r);
+            undo[undoCount++] = { r, w.blocked, w.reach };
+            w.blocked |= 1ULL << spans[k].lane;
+        }
+        if (r0 <= r1) {
+            first = std::min(first, r0);
+            last = std::max(last, r1);
+        }
+    }
+
+    if (fits && (first > last || sweep(first, last)))
+        return true;
+
+    rollBack(sweptBefore);
+    return false;
+}
+
+/* Forgets every row and starts at the runner's row with lanes. */
+void startRoad(uint64_t lanes) {
+
+    for (Row& w : rows)
+        w.row = LONG_MIN;
+    stepJump();
+
+    firstRow = (long)std::floor(roadDistance() / rowLength);
+    sweptTo = firstRow + 1;
+    rowAt(firstRow).reach = lanes & allLanes();
+}
+
+/* Road position the runner picks up a power-up in segment seg at. */
+double pickupAt(long seg) {
+    return roadDistance() - (segmentZ(seg) + roadOffset);
+}
+
+/* Road slow motion taken at road position at may slow down, with ticks
+   of it to run: from the take-off of a jump still in the air then, to
+   the end of the slowed road at the fastest scroll speed by then. */
+SlowStretch slowStretch(double at, double ticks) {
+    const double fast = scrollSpeedAt(at + ticks * maxScrollSpeed);
+    return { at - pickupReach - jumpLanded * fast,
+             at + pickupReach + ticks * slowMotionScale * fast };
+}
+
+/* Every row from r0 to r1 planned again, with the stretches as they
+   are now. */
+void replanRows(long r0, long r1) {
+    for (long r = std::max(r0, firstRow + 1); r <= r1; r++)
+        planRow(rowAt(r), r);
+}
+
+/* Slow motion running and to be picked up, and the cars, are checked
+   back in; a car that no longer fits, one the runner is already too
+   close to for a way round, stays on the road. */
+void checkCarsIn() {
+
+    static int cars[maxCars];
+    const int n = traffic.count;
+
+    slowStretches.clear();
+    if (slowMotionTime > 0.0f)
+        slowStretches.push_back(slowStretch(roadDistance(),
+                                            slowMotionTime));
+    for (const PowerUp& pu : powerUps)
+        if (pu.kind == POWERUP_SLOWMO && !pu.collected)
+            slowStretches.push_back(slowStretch(pickupAt(pu.seg),
+                                                slowMotionDuration));
+
+    startRoad(allLanes());
+    for (int i = 0; i < n; i++)
+        cars[i] = i;
+
+    std::sort(cars, cars + n,
+              [](int a, int b) { return traffic.z[a] > traffic.z[b]; });
+    for (int k = 0; k < n; k++)
+        admitCar(cars[k]);
+}
+
+/* Rows the runner has got to with no car in them since the last sweep
+   still need their reach. */
+void catchUp() {
+    long runnerRow = (long)std::floor(roadDistance() / rowLength);
+    for (; sweptTo <= runnerRow; sweptTo++)
+        rowAt(sweptTo).reach = workOutReach(sweptTo);
+}
+
+/* Cars by the lanes they are in or will be in (counting sort), built
+   once per segment placed; cars added since are looked at one by
+   one. */
+int laneStart[maxLanes + 1];
+int laneCars[2 * maxCars];
+int indexed;
+
+void indexLanes() {
+
+    static int fill[maxLanes];
+    CarSpan spans[2];
+
+    std::fill(laneStart, laneStart + laneCount + 1, 0);
+    indexed = traffic.count;
+
+    for (int i = 0; i < indexed; i++) {
+        int n = carSpans(i, spans);
+        for (int k = 0; k < n; k++)
+            laneStart[spans[k].lane + 1]++;
+    }
+    for (int l = 0; l < laneCount; l++) {
+        fill[l] = laneStart[l];
+        laneStart[l + 1] += laneStart[l];
+    }
+
+    for (int i = 0; i < indexed; i++) {
+        int n = carSpans(i, spans);
+        for (int k = 0; k < n; k++)
+            laneCars[fill[spans[k].lane]++] = i;
+    }
+}
+
+/* Speeds of the car being placed, between low and high, that would
+   bring it too close to another car; the ends are fine, give or take
+   float rounding. */
+struct Band {
+    double low, high;
+};
+
+std::vector<Band> bands;
+
+/* Adds the bands of car i's speeds that would bring car j closer than
+   carGap (or, if they already are closer in the same lane, any closer)
+   while both are in one of car i's spans. Car i either keeps ahead of
+   car j all that time or keeps behind it. */
+void keepApart(int i, const CarSpan* mine, int n, int j) {
+
+    const TrafficPool& t = traffic;
+    CarSpan theirs[2];
+    const int m = carSpans(j, theirs);
+    double leave = -1.0;
+
+    for (int a = 0; a < n; a++)
+        for (int b = 0; b < m; b++) {
+            if (mine[a].lane != theirs[b].lane)
+                continue;
+            if (leave < 0.0)
+                leave = leaveTime(j);
+
+            double t0 = std::max(mine[a].from, theirs[b].from);
+            double t1 = std::min(std::min((double)mine[a].to,
+                                          (double)theirs[b].to), leave);
+            if (t0 > t1)
+                continue;
+
+            /* The gap, car j behind car i, is d + (speed i - speed j)
+               times the time; linear, so the ends of [t0, t1] do. */
+            const double d = t.z[j] - t.z[i];
+            const double sj = t.speed[j];
+            double need = carGap;
+            if (mine[a].from == 0.0f && theirs[b].from == 0.0f)
+                need = std::min(need, std::fabs(d));
+
+            double ahead = sj, behind = sj;
+            for (double at : { t0, t1 }) {
+                if (at > 1e29)
+                    continue;
+                if (at > 0.0) {
+                    ahead = std::max(ahead, sj + (need - d) / at);
+                    behind = std::min(behind, sj - (need + d) / at);
+                } else {
+                    if (d < need)
+                        ahead = 1e30;
+                    if (d > -need)
+                        behind = -1e30;
+                }
+            }
+            if (behind < maxCarSpeed && ahead > minCarSpeed)
+                bands.push_back({ behind, ahead });
+        }
+}
+
+/* True if car j is in lane now. */
+bool inLaneNow(int j, int lane) {
+    CarSpan spans[2];
+    const int m = carSpans(j, spans);
+    for (int b = 0; b < m; b++)
+        if (spans[b].lane == lane && spans[b].from == 0.0f)
+            return true;
+    return false;
+}
+
+/* Car i, spawned onto the tail of a car in its lane, goes a car length
+   ahead of it (still past the drawn road). */
+void clearTail(int i) {
+
+    TrafficPool& t = traffic;
+    const int lane = t.lane[i];
+
+    auto check = [&](int j) {
+        if (j == i || std::fabs(t.z[j] - t.z[i]) >= carLength ||
+            !inLaneNow(j, lane))
+            return false;
+        t.z[i] = t.z[j] - carLength;
+        return true;
+    };
+
+    for (bool moved = true; moved; ) {
+        moved = false;
+        for (int c = laneStart[lane]; c < laneStart[lane + 1]; c++)
+            moved |= check(laneCars[c]);
+        for (int j = indexed; j < t.count; j++)
+            moved |= check(j);
+    }
+}
+
+/* Gives car i the speed nearest its own that keeps it clear of every
+   other car; false if there is none. */
+bool fitCar(int i) {
+
+    TrafficPool& t = traffic;
+    CarSpan mine[2];
+    const int n = carSpans(i, mine);
+
+    clearTail(i);
+    bands.clear();
+    for (int k = 0; k < n; k++)
+        for (int c = laneStart[mine[k].lane];
+             c < laneStart[mine[k].lane + 1]; c++)
+            keepApart(i, mine, n, laneCars[c]);
+
+    for (int j = indexed; j < t.count; j++)
+        if (j != i)
+            keepApart(i, mine, n, j);
+
+    /* Merged, the bands that overlap (by more than float rounding)
+       leave one that holds the car's own speed, or none; the nearest
+       clear speeds are its ends. */
+    std::sort(bands.begin(), bands.end(),
+              [](const Band& a, const Band& b) { return a.low < b.low; });
+
+    const double own = t.speed[i];
+    const double eps = 1e-6;
+    for (size_t k = 0; k < bands.size(); ) {
+        double low = bands[k].low, high = bands[k].high;
+        for (k++; k < bands.size() && bands[k].low + eps < high - eps; k++)
+            high = std::max(high, bands[k].high);
+        if (own <= low + eps || own >= high - eps)
+            continue;
+
+        bool down = low >= minCarSpeed, up = high <= maxCarSpeed;
+        if (!down && !up)
+            return false;
+        t.speed[i] = (float)(down && (!up || own - low < high - own) ?
+                             low : high);
+        return true;
+    }
+    return true;
+}
+
+/* Car i as it is, then without its lane change. */
+bool tryCar(int i) {
+
+    const float speed = traffic.speed[i];
+    if (traffic.nextLane[i] != traffic.lane[i]) {
+        if (fitCar(i) && admitCar(i))
+            return true;
+        traffic.speed[i] = speed;
+        keepLane(i);
+    }
+    return fitCar(i) && admitCar(i);
+}
+
+}
+
+void resetReachability() {
+
+    uint64_t lanes = 0;
+    for (int p = 0; p < playerCount; p++)
+        if (!runners[p].out)
+            lanes |= 1ULL << runners[p].lane;
+    slowStretches.clear();
+    startRoad(lanes);
+    rebuild = false;
+}
+
+void placeCars(long seg, bool* hasCar, const uint32_t* seeds) {
+
+    bool wanted[maxLanes];
+    std::copy(hasCar, hasCar + laneCount, wanted);
+    std::fill(hasCar, hasCar + laneCount, false);
+
+    if (rebuild) {
+        checkCarsIn();
+        rebuild = false;
+    }
+    catchUp();
+    indexLanes();
+
+    for (int lane = 0; lane < laneCount; lane++) {
+        if (!wanted[lane])
+            continue;
+
+        /* Its own lane, then the free ones nearest to it. */
+        bool placed = false;
+        int tries = 0;
+        for (int d = 0; d < laneCount && !placed &&
+                        tries <= maxMovedLanes; d++)
+            for (int side = d ? -1 : 1; side <= 1 && !placed; side += 2) {
+                int to = lane + side * d;
+                if (to < 0 || to >= laneCount || hasCar[to] ||
+                    (d && wanted[to]))
+                    continue;
+                int i = addCar(seg, to, seeds[lane]);
+                if (i < 0)
+                    return;
+                tries++;
+                if (tryCar(i)) {
+                    hasCar[to] = placed = true;
+                    movedCars += to != lane;
+                } else {
+                    removeCar(i);
+                }
+            }
+        droppedCars += !placed;
+    }
+}
+
+bool placeSlowMotion(long seg) {
+
+    const double behind = roadDistance() - lookBack * rowLength;
+    slowStretches.erase(
+        std::remove_if(slowStretches.begin(), slowStretches.end(),
+                       [=](const SlowStretch& s) { return s.to < behind; }),
+        slowStretches.end());
+
+    const SlowStretch s = slowStretch(pickupAt(seg), slowMotionDuration);
+    const long r0 = (long)std::floor(s.from / rowLength);
+    const long r1 = (long)std::floor(s.to / rowLength);
+
+    slowStretches.push_back(s);
+    replanRows(r0, r1);
+
+    undoCount = 0;
+    const long sweptBefore = sweptTo;
+    if (sweep(r0, r1))
+        return true;
+
+    rollBack(sweptBefore);
+    slowStretches.pop_back();
+    replanRows(r0, r1);
+    return false;
+}
+
+void rebuildReachability() {
+    rebuild = true;
+}
@@ -0,0 +1,59 @@
+#ifndef STREET_RUNNER_REACHABILITY_H
+#define STREET_RUNNER_REACHABILITY_H
+
+#include <cstdint>
+
+/* ========================================================================
+   REACHABILITY
+   ========================================================================
+   Every car's way along the road is fixed when it is spawned (traffic.h)
+   and the scroll speed is a function of road distance (scrollSpeedAt()),
+   so where the runner meets each car, and in which lane the car is by
+   then, can be solved for exactly: the runner closes the gap at its
+   ramping speed less the car's, and the road it covers while the car is
+   within carHitReach is blocked in the lanes the car is in meanwhile.
+
+   The road is cut into rows of rowLength by road distance, with one
+   64-bit mask of blocked lanes per row and one of the lanes the runner
+   can start the row in, on the ground and free to change lane. A row's
+   lanes come from the row before (staying put), from the rows a lane
+   change to a neighbouring lane takes, laneSpeed and the ticks each row
+   lasts permitting, and from the rows a jump can take off in to land in
+   this one, the ticks above car roof height JUMP_FORCE and GRAVITY give
+   and the lanes crossed in the air included. Jumps are timed at the
+   normal scroll rate. Slow motion shortens them, so rows a jump from
+   which may be slowed down, from a slow-motion power-up's pickup on for
+   slowMotionDuration, get none; lane changes only take fewer rows.
+
+   Cars are placed as their segment is spawned, at the far end of the
+   drawn road. One that would run into another car gets another speed
+   or keeps its lane; one that would leave some row with no lane at all
+   is moved to a free lane of its segment nearby, or left out. So is a
+   slow-motion power-up that would. Placing either sweeps the rows from
+   its own on until they come out as before, some lookBack rows past it.
+   ======================================================================== */
+
+/* Starts the road from the lanes the runners are in. resetGame() calls
+   it before spawning. */
+void resetReachability();
+
+/* Places segment seg's cars: hasCar says which lanes want one (seeded
+   from seeds[lane]) and comes back with the lanes that have one. Cars
+   moved to another lane are counted in movedCars, cars left out in
+   droppedCars. spawn() calls it. */
+void placeCars(long seg, bool* hasCar, const uint32_t* seeds);
+
+/* Takes the jumps out of the rows a slow-motion power-up in segment
+   seg may slow down; false, leaving them be, if that leaves the runner
+   no way through and the power-up must not be spawned. spawn() calls
+   it after placeCars(). */
+bool placeSlowMotion(long seg);
+
+/* Has the next placeCars() start again at the runner's road position,
+   from every lane, and check the slow-motion power-ups and cars on the
+   road back in first.
+   loadSnapshot() calls it; a rewind restoring snapshot after snapshot
+   only pays for it once play goes on. */
+void rebuildReachability();
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef STREET_RUNNER_RENDERER_H
+#define STREET_RUNNER_RENDERER_H
+
+#include "math3d.h"
+
+/* ========================================================================
+   RENDERER INTERFACE
+   ========================================================================
+   The scene code talks to this instead of GL so the same geometry can be
+   drawn by the GL window (gl_renderer.cpp) or rasterized on the CPU
+   (soft_renderer.cpp). Calls map one-to-one onto the fixed-function
+   subset the game uses: a modelview stack, glBegin/glEnd batches and
+   the GLUT/GLU solids.
+   ======================================================================== */
+
+enum PrimitiveType { PRIM_POINTS, PRIM_TRIANGLES, PRIM_QUADS };
+
+enum SolidKind { SOLID_CUBE, SOLID_SPHERE, SOLID_CONE,
+                 SOLID_CYLINDER, SOLID_TORUS };
+
+/* One of the solids below with its parameters, in the same order as
+   the matching call: cube (size), sphere (radius, slices, stacks),
+   cone (base, height, slices, stacks), cylinder (base, top, height,
+   slices, stacks), torus (inner, outer, sides, rings). */
+struct SolidShape {
+    SolidKind kind;
+    float a, b, c;
+    int i, j;
+};
+
+enum BlendMode {
+    BLEND_NONE,
+    BLEND_ALPHA,      /* GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA */
+    BLEND_ADDITIVE    /* GL_SRC_ALPHA, GL_ONE */
+};
+
+class Renderer {
+public:
+    virtual ~Renderer() {}
+
+    /* Size of the current viewport (the whole target by default). */
+    virtual int width() const = 0;
+    virtual int height() const = 0;
+
+    /* Restricts drawing to a rectangle of the target, x and y from the
+       bottom-left corner as in glViewport; a zero width or height goes
+       back to the whole target. Projections set afterwards (including
+       the overlay's) fit the rectangle. */
+    virtual void setViewport(int x, int y, int w, int h) = 0;
+
+    /* Clears colour and depth of the whole target for a new frame. */
+    virtual void clear() = 0;
+
+    /* Projection for the 3D scene; the overlay pair below swaps in a
+       pixel-space ortho projection and identity modelview. */
+    virtual void setPerspective(float fovy, float aspect,
+                                float zn, float zf) = 0;
+    virtual void beginOverlay() = 0;
+    virtual void endOverlay() = 0;
+
+    /* Replaces the modelview matrix with a camera transform. */
+    virtual void setCamera(float ex, float ey, float ez,
+                           float cx, float cy, float cz,
+                           float ux, float uy, float uz) = 0;
+
+    /* Position is transformed by the current modelview, as in GL. */
+    virtual void setLightPosition(float x, float y, float z, float w) = 0;
+
+    virtual void setLighting(bool on) = 0;
+    virtual void setDepthTest(bool on) = 0;
+    virtual void setBlend(BlendMode blend) = 0;
+    virtual void setLineWidth(float w) = 0;
+
+    virtual void pushMatrix() = 0;
+    virtual void popMatrix() = 0;
+    virtual void translate(float x, float y, float z) = 0;
+    virtual void rotate(float angle, float x, float y, float z) = 0;
+    virtual void scale(float x, float y, float z) = 0;
+
+    virtual void color(float r, float g, float b, float a = 1.0f) = 0;
+    virtual void normal(float x, float y, float z) = 0;
+
+    virtual void begin(PrimitiveType prim) = 0;
+    virtual void vertex(float x, float y, float z) = 0;
+    virtual void end() = 0;
+
+    /* A whole point cloud in one submission: xyz and rgba per point,
+       drawn as size x size pixel squares. */
+    virtual void drawPointArray(const float* xyz, const float* rgba,
+                                int count, float size) = 0;
+
+    /* A triangle list in one submission: xyz, normal and rgba per
+       vertex, lit like immediate-mode vertices. */
+    virtual void drawTriangleArray(const float* xyz, const float* normals,
+                                   const float* rgba, int count) = 0;
+
+    /* glutSolid* / gluCylinder equivalents. */
+    virtual void solidCube(float size) = 0;
+    virtual void solidSphere(float radius, int slices, int stacks) = 0;
+    virtual void solidCone(float base, float height,
+                           int slices, int stacks) = 0;
+    virtual void cylinder(float base, float top, float height,
+                          int slices, int stacks) = 0;
+    virtual void solidTorus(float inner, float outer,
+                            int sides, int rings) = 0;
+
+    /* The same solid once per model matrix (applied on top of the
+       current modelview), in the current colour. Replaces a push /
+       translate / rotate / scale / pop sequence per object with one
+       call per batch. */
+    virtual void drawSolidInstances(const SolidShape& shape,
+                                    const Mat4* models, int count) = 0;
+};
+
+/* Adapter so the algorithms.h generators can emit into a Renderer. */
+struct RendererPointSink {
+    Renderer& r;
+    void begin() { r.begin(PRIM_POINTS); }
+    void vertex(float x, float y, float z) { r.vertex(x, y, z); }
+    void end() { r.end(); }
+};
+
+#endif
@@ -0,0 +1,678 @@
+#include "scene.h"
+#include "game.h"
+#include "algorithms.h"
+#include "particles.h"
+#include "traffic.h"
+#include "poses.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+/* ========================================================================
+   CUSTOM ALGORITHMS
+   ======================================================================== */
+
+void drawLineDDA(Renderer& r,
+                 float x1, float y1, float z1,
+                 float x2, float y2, float z2) {
+    RendererPointSink sink = { r };
+    emitLineDDA(sink, x1, y1, z1, x2, y2, z2);
+}
+
+void drawMidpointCirclePoints(Renderer& r, int radius, float pixelScale) {
+    RendererPointSink sink = { r };
+    emitMidpointCirclePoints(sink, radius, pixelScale);
+}
+
+void drawFilledMidpointCircle(Renderer& r, int radius, float scale) {
+    RendererPointSink sink = { r };
+    emitFilledMidpointCircle(sink, radius, scale);
+}
+
+/* ========================================================================
+   BACKGROUND WITH DAYNIGHT CYCLE
+   ======================================================================== */
+
+void drawCloud2D(Renderer& r, float cx, float cy, float scale) {
+
+    r.pushMatrix();
+    r.translate(cx, cy, 0);
+    r.scale(scale, scale * 0.6f, 1.0f);
+
+    r.color(1.0f, 1.0f, 1.0f, 0.8f);
+
+    r.pushMatrix(); r.translate(-30, -10, 0);
+    drawFilledMidpointCircle(r, 25, 1.0f);
+    r.popMatrix();
+
+    r.pushMatrix(); r.translate(0, 0, 0);
+    drawFilledMidpointCircle(r, 35, 1.0f);
+    r.popMatrix();
+
+    r.pushMatrix(); r.translate(30, -10, 0);
+    drawFilledMidpointCircle(r, 25, 1.0f);
+    r.popMatrix();
+
+    r.pushMatrix(); r.translate(15, 15, 0);
+    drawFilledMidpointCircle(r, 20, 1.0f);
+    r.popMatrix();
+
+    r.popMatrix();
+}
+
+void drawAttractiveBackground(Renderer& r) {
+
+    float w = (float)r.width();
+    float h = (float)r.height();
+
+    r.setLighting(false);
+    r.setDepthTest(false);
+
+    r.beginOverlay();
+
+    float t = (sin(dayCycle) + 1.0f) * 0.5f;
+
+    r.begin(PRIM_QUADS);
+
+    r.color(0.05f + 0.3f*t,
+            0.2f  + 0.4f*t,
+            0.4f  + 0.4f*t);
+    r.vertex(0, h, 0);
+    r.vertex(w, h, 0);
+
+    r.color(0.0f + 0.2f*t,
+            0.1f + 0.3f*t,
+            0.2f + 0.6f*t);
+    r.vertex(w, 0, 0);
+    r.vertex(0, 0, 0);
+
+    r.end();
+
+    r.setBlend(BLEND_ALPHA);
+
+    drawCloud2D(r, w * 0.2f, h * 0.85f, 1.5f);
+    drawCloud2D(r, w * 0.75f, h * 0.75f, 2.0f);
+    drawCloud2D(r, w * 0.45f, h * 0.9f, 1.2f);
+
+    r.pushMatrix();
+    r.translate(w * 0.85f, h * 0.85f, 0);
+    r.color(1.0f, 1.0f, 0.0f);
+    drawFilledMidpointCircle(r, 60, 1.0f);
+    r.popMatrix();
+
+    r.setBlend(BLEND_NONE);
+
+    r.endOverlay();
+
+    r.setDepthTest(true);
+    r.setLighting(true);
+}
+/* ========================================================================
+   3D MODELS AND SCENERY
+   ======================================================================== */
+
+/* Trees, cars and coins come in batches: the model matrices of every
+   visible instance are composed in one pass and submitted together,
+   instead of a push / translate / rotate / pop per object. */
+
+static const SolidShape treeTrunk =
+    { SOLID_CYLINDER, 0.25f, 0.25f, 1.5f, 8, 1 };
+static const SolidShape treeCrown =
+    { SOLID_CONE, 1.0f, 2.3f, 0.0f, 10, 2 };
+static const SolidShape carBox =
+    { SOLID_CUBE, 1.0f, 0.0f, 0.0f, 0, 0 };
+static const SolidShape carWheel =
+    { SOLID_TORUS, 0.05f, 0.13f, 0.0f, 10, 16 };
+static const SolidShape magnetShape =
+    { SOLID_TORUS, 0.1f, 0.3f, 0.0f, 10, 16 };
+static const SolidShape shieldShape =
+    { SOLID_SPHERE, 0.35f, 0.0f, 0.0f, 12, 12 };
+static const SolidShape slowMotionShape =
+    { SOLID_CUBE, 0.5f, 0.0f, 0.0f, 0, 0 };
+
+/* Appends local placed at (x[k], y, z[k]) for every k. */
+static void composeBatch(std::vector<Mat4>& out, const Mat4& local,
+                         const float* x, float y, const float* z, int n) {
+    size_t at = out.size();
+    out.resize(at + n);
+    mat4TranslateBatch(local, x, y, z, n, out.data() + at);
+}
+
+static void buildTrees(WorldView& v, const float* x, const float* z, int n) {
+
+    const Mat4 upright = mat4Rotation(-90, 1, 0, 0);
+
+    composeBatch(v.trunks, upright, x, 0.0f, z, n);
+    composeBatch(v.crowns, upright, x, 1.5f, z, n);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void drawWindmill(Renderer& r, float x, float z) {
+
+    r.color(0.85f, 0.85f, 0.85f);
+
+    r.pushMatrix();
+    r.translate(x, 0.0f, z);
+    r.rotate(-90, 1, 0, 0);
+
+    r.cylinder(0.5f, 0.25f, 5.0f, 12, 1);
+
+    r.popMatrix();
+
+    r.pushMatrix();
+    r.translate(x, 5.0f, z);
+    r.rotate(windmillAngle, 0, 0, 1);
+
+    r.color(0.8f, 0.0f, 0.0f);
+
+    for (int i = 0; i < 4; i++) {
+        r.pushMatrix();
+        r.rotate(90.0f * i, 0, 0, 1);
+        r.translate(0, 1.5f, 0);
+        r.scale(0.4f, 3.0f, 0.1f);
+        r.solidCube(1.0f);
+        r.popMatrix();
+    }
+
+    r.popMatrix();
+}
+
+/* ---------------------------------------------------------------------- */
+
+void drawCartoonHouse(Renderer& r, float x, float z) {
+
+    r.pushMatrix();
+    r.translate(x, 0, z);
+    r.scale(2.5f, 2.5f, 2.5f);
+    r.setLineWidth(3.0f);
+
+    r.color(1.0f, 1.0f, 1.0f);
+    drawLineDDA(r, -1, 0, 0, -1, 1, 0);
+    drawLineDDA(r, 1, 0, 0, 1, 1, 0);
+    drawLineDDA(r, -1, 0, 0, 1, 0, 0);
+    drawLineDDA(r, -1, 1, 0, 1, 1, 0);
+
+    r.color(1.0f, 0.0f, 0.0f);
+    drawLineDDA(r, -1.2f, 1, 0, 0, 1.8f, 0);
+    drawLineDDA(r, 1.2f, 1, 0, 0, 1.8f, 0);
+    drawLineDDA(r, -1.2f, 1, 0, 1.2f, 1, 0);
+
+    r.color(0.6f, 0.3f, 0.1f);
+    drawLineDDA(r, -0.3f, 0, 0, -0.3f, 0.6f, 0);
+    drawLineDDA(r, 0.3f, 0, 0, 0.3f, 0.6f, 0);
+    drawLineDDA(r, -0.3f, 0.6f, 0, 0.3f, 0.6f, 0);
+
+    r.color(1.0f, 1.0f, 0.0f);
+    r.pushMatrix();
+    r.translate(0.15f, 0.3f, 0.05f);
+    drawFilledMidpointCircle(r, 3, 0.02f);
+    r.popMatrix();
+
+    r.setLineWidth(1.0f);
+    r.popMatrix();
+}
+
+/* ---------------------------------------------------------------------- */
+
+void drawCartoonCharacter(Renderer& r, float x, float z) {
+
+    /* The DDA / midpoint circle points for the current wave come from
+       the pose cache; the bob is just an offset. */
+    float bob = sin(distanceScore * 0.1f + x) * 0.05f;
+    float wave = std::abs(sin(distanceScore * 0.2f + z)) * 0.3f;
+    const PosePoints& pose = characterPose(wave);
+
+    r.pushMatrix();
+    r.translate(x, 0.7f + bob * 1.5f, z);
+    r.drawPointArray(pose.positions.data(), pose.colors.data(),
+                     pose.count(), 1.0f);
+    r.popMatrix();
+}
+
+/* ---------------------------------------------------------------------- */
+/* COIN WITH GLOW (no algorithm removed) */
+/* ---------------------------------------------------------------------- */
+
+/* algorithms.h sink collecting points, pushed dz along z. */
+struct PointListSink {
+    std::vector<float>& xyz;
+    float dz;
+
+    void begin() {}
+    void end() {}
+    void vertex(float x, float y, float z) {
+        xyz.push_back(x);
+        xyz.push_back(y);
+        xyz.push_back(z + dz);
+    }
+};
+
+/* Three stacked midpoint-circle discs per coin. The disc points are
+   generated once; each frame every coin's matrix is composed in one
+   batch and the points are transformed through it on the CPU, so the
+   whole set goes out as a single point draw. */
+static void buildCoins(WorldView& v, const float* x, const float* z, int n) {
+
+    static std::vector<float> disc;
+    if (disc.empty())
+        for (float dz : { 0.0f, 0.05f, -0.05f }) {
+            PointListSink sink = { disc, dz };
+            emitFilledMidpointCircle(sink, 12, 0.02f);
+        }
+
+    if (n == 0)
+        return;
+
+    static std::vector<Mat4> models;
+    const int perCoin = (int)(disc.size() / 3);
+    const Mat4 spin =
+        mat4Rotation((float)(distanceScore % 360) * 4.0f, 0, 1, 0);
+
+    models.resize(n);
+    mat4TranslateBatch(spin, x, 0.9f, z, n, models.data());
+
+    v.coinXyz.resize((size_t)n * perCoin * 3);
+    for (size_t k = v.coinRgba.size() / 4; k < (size_t)n * perCoin; k++)
+        v.coinRgba.insert(v.coinRgba.end(), { 1.0f, 0.85f, 0.0f, 0.8f });
+
+    for (int i = 0; i < n; i++)
+        mat4TransformPoints(models[i], disc.data(), perCoin,
+                            &v.coinXyz[(size_t)i * perCoin * 3]);
+}
+
+/* ---------------------------------------------------------------------- */
+/* ROBOT WITH SHADOW */
+/* ---------------------------------------------------------------------- */
+
+void drawRunner(Renderer& r, float x, float y, bool shielded) {
+
+    float runAnim =
+        (mode == PLAYING)
+        ? sin(distanceScore * 0.2f) * 30.0f
+        : 0.0f;
+
+    /* SHADOW */
+    r.setLighting(false);
+    r.color(0, 0, 0, 0.3f);
+    r.pushMatrix();
+    r.translate(x, 0.01f, 0.0f);
+    r.scale(1.0f, 0.1f, 1.2f);
+    r.solidSphere(0.4f, 12, 12);
+    r.popMatrix();
+    r.setLighting(true);
+
+    /* BODY: body, head, arms and legs for this runAnim, pre-baked */
+    const PoseMesh& pose = robotPose(runAnim);
+
+    r.pushMatrix();
+    r.translate(x, y + 0.6f, 0.0f);
+    r.drawTriangleArray(pose.positions.data(), pose.normals.data(),
+                        pose.colors.data(), pose.vertexCount());
+
+    if (shielded) {
+        r.setBlend(BLEND_ALPHA);
+        r.color(0.3f, 0.8f, 1.0f, 0.3f);
+        r.solidSphere(0.9f, 16, 16);
+        r.setBlend(BLEND_NONE);
+    }
+
+    r.popMatrix();
+}
+
+void drawRobot(Renderer& r) {
+    drawRunner(r, playerX, playerY, shieldTime > 0.0f);
+}
+
+/* ========================================================================
+   CAR MODEL
+   ======================================================================== */
+
+static void buildCars(WorldView& v, const float* x, const float* z, int n) {
+
+    composeBatch(v.carBodies, mat4Scaling(1.4f, 0.6f, 2.0f),
+                 x, 0.35f, z, n);
+
+    composeBatch(v.carRoofs,
+                 mat4Multiply(mat4Translation(0.0f, 0.45f, -0.2f),
+                              mat4Scaling(1.0f, 0.45f, 1.0f)),
+                 x, 0.35f, z, n);
+
+    for (int sx = -1; sx <= 1; sx += 2)
+        for (int sz = -1; sz <= 1; sz += 2)
+            composeBatch(v.carWheels,
+                         mat4Translation(0.55f * sx, -0.35f, 0.75f * sz),
+                         x, 0.35f, z, n);
+}
+
+/* ========================================================================
+   POWER-UPS
+   ======================================================================== */
+
+static void buildPowerUps(WorldView& v) {
+
+    static std::vector<float> x[powerUpKinds], z[powerUpKinds];
+    std::vector<Mat4>* models[powerUpKinds] =
+        { &v.magnets, &v.shields, &v.slowMotions };
+
+    for (int k = 0; k < powerUpKinds; k++) {
+        x[k].clear();
+        z[k].clear();
+    }
+
+    for (const PowerUp& p : powerUps) {
+        float pz = segmentZ(p.seg);
+        if (!p.collected && pz > -160 && pz < 10) {
+            x[p.kind].push_back(laneX(p.lane));
+            z[p.kind].push_back(pz);
+        }
+    }
+
+    const Mat4 spin =
+        mat4Rotation((float)(distanceScore % 360) * 3.0f, 0, 1, 0);
+
+    for (int k = 0; k < powerUpKinds; k++)
+        composeBatch(*models[k], spin, x[k].data(), 1.0f, z[k].data(),
+                     (int)x[k].size());
+}
+
+/* ========================================================================
+   DRAW WORLD (ALL SCENERY PRESERVED)
+   ======================================================================== */
+
+static void addGroundQuad(WorldView& v, float x0, float x1, float y,
+                          float zn, float zf,
+                          float r, float g, float b) {
+    const float corners[6][2] = {
+        { x0, zn }, { x1, zn }, { x1, zf },
+        { x0, zn }, { x1, zf }, { x0, zf }
+    };
+    for (const auto& c : corners) {
+        v.groundXyz.insert(v.groundXyz.end(), { c[0], y, c[1] });
+        v.groundNormals.insert(v.groundNormals.end(), { 0.0f, 1.0f, 0.0f });
+        v.groundRgba.insert(v.groundRgba.end(), { r, g, b, 1.0f });
+    }
+}
+
+void buildWorldView(WorldView& v) {
+
+    static std::vector<float> batchX, batchZ;
+
+    v.roadOffset = roadOffset;
+
+    v.groundXyz.clear();
+    v.groundNormals.clear();
+    v.groundRgba.clear();
+    v.stripeXyz.clear();
+    v.trunks.clear();
+    v.crowns.clear();
+    v.carBodies.clear();
+    v.carRoofs.clear();
+    v.carWheels.clear();
+    v.coinXyz.clear();
+    v.magnets.clear();
+    v.shields.clear();
+    v.slowMotions.clear();
+    v.windmills.clear();
+    v.houses.clear();
+    v.characters.clear();
+
+    batchX.clear();
+    batchZ.clear();
+
+    const float grass = std::max(50.0f, roadHalfWidth + 40.0f);
+
+    for (int i = -1; i < visibleSegments; i++) {
+
+        long seg = currentSegment + i;
+
+        float zn = -i * segmentLength;
+        float zf = -(i + 1) * segmentLength;
+        float zm = (zn + zf) * 0.5f;
+
+        addGroundQuad(v, -roadHalfWidth, roadHalfWidth, 0.0f, zn, zf,
+                      0.25f, 0.25f, 0.25f);
+
+        if (i % 2 == 0) {
+            PointListSink sink = { v.stripeXyz, 0.0f };
+            for (int lane = 1; lane < laneCount; lane++) {
+                float x = laneX(lane) - laneWidth * 0.5f;
+                emitLineDDA(sink, x, 0.02f, zn, x, 0.02f, zf);
+            }
+        }
+
+        addGroundQuad(v, -grass, -roadHalfWidth, -0.1f, zn, zf,
+                      0.1f, 0.6f, 0.1f);
+        addGroundQuad(v, roadHalfWidth, grass, -0.1f, zn, zf,
+                      0.1f, 0.6f, 0.1f);
+
+        const SegmentScenery& sc = sceneryFor(seg);
+
+        for (int k = 0; k < sc.count; k++) {
+
+            const SceneryItem& it = sc.items[k];
+            float x = it.side * (roadHalfWidth + it.offset);
+
+            switch (it.type) {
+                case SCENERY_TREE:
+                    batchX.push_back(x);
+                    batchZ.push_back(zm);
+                    break;
+                case SCENERY_WINDMILL:
+                    v.windmills.insert(v.windmills.end(), { x, zm });
+                    break;
+                case SCENERY_HOUSE:
+                    v.houses.insert(v.houses.end(), { x, zm });
+                    break;
+                case SCENERY_CHARACTER:
+                    v.characters.insert(v.characters.end(), { x, zm });
+                    break;
+            }
+        }
+    }
+
+    for (size_t k = v.stripeRgba.size() / 4; k < v.stripeXyz.size() / 3; k++)
+        v.stripeRgba.insert(v.stripeRgba.end(), { 1.0f, 1.0f, 0.0f, 1.0f });
+
+    buildTrees(v, batchX.data(), batchZ.data(), (int)batchX.size());
+
+    batchX.clear();
+    batchZ.clear();
+    for (int i = 0; i < traffic.count; i++) {
+        float z = traffic.z[i];
+        if (z > -160 && z < 10) {
+            batchX.push_back(traffic.x[i]);
+            batchZ.push_back(z);
+        }
+    }
+    buildCars(v, batchX.data(), batchZ.data(), (int)batchX.size());
+
+    batchX.clear();
+    batchZ.clear();
+    for (auto &cn : coins) {
+        if (!cn.collected) {
+            float z = segmentZ(cn.seg);
+            if (z > -160 && z < 10) {
+                batchX.push_back(laneX(cn.lane));
+                batchZ.push_back(z);
+            }
+        }
+    }
+    buildCoins(v, batchX.data(), batchZ.data(), (int)batchX.size());
+
+    buildPowerUps(v);
+
+    v.particleXyz.resize(maxParticles * 3);
+    v.particleRgba.resize(maxParticles * 4);
+    v.particleCount = packParticles(v.particleXyz.data(),
+                                    v.particleRgba.data());
+}
+
+void drawWorldView(Renderer& r, const WorldView& v) {
+
+    r.pushMatrix();
+    r.translate(0, 0, v.roadOffset);
+
+    r.drawTriangleArray(v.groundXyz.data(), v.groundNormals.data(),
+                        v.groundRgba.data(), (int)(v.groundXyz.size() / 3));
+
+    r.setLighting(false);
+    r.drawPointArray(v.stripeXyz.data(), v.stripeRgba.data(),
+                     (int)(v.stripeXyz.size() / 3), 1.0f);
+    r.setLighting(true);
+
+    for (size_t k = 0; k < v.windmills.size(); k += 2)
+        drawWindmill(r, v.windmills[k], v.windmills[k + 1]);
+    for (size_t k = 0; k < v.houses.size(); k += 2)
+        drawCartoonHouse(r, v.houses[k], v.houses[k + 1]);
+    for (size_t k = 0; k < v.characters.size(); k += 2)
+        drawCartoonCharacter(r, v.characters[k], v.characters[k + 1]);
+
+    r.color(0.55f, 0.27f, 0.07f);
+    r.drawSolidInstances(treeTrunk, v.trunks.data(), (int)v.trunks.size());
+    r.color(0.1f, 0.7f, 0.1f);
+    r.drawSolidInstances(treeCrown, v.crowns.data(), (int)v.crowns.size());
+
+    r.color(0.85f, 0.1f, 0.1f);
+    r.drawSolidInstances(carBox, v.carBodies.data(),
+                         (int)v.carBodies.size());
+    r.color(0.75f, 0.05f, 0.05f);
+    r.drawSolidInstances(carBox, v.carRoofs.data(), (int)v.carRoofs.size());
+    r.color(0.1f, 0.1f, 0.1f);
+    r.drawSolidInstances(carWheel, v.carWheels.data(),
+                         (int)v.carWheels.size());
+
+    r.color(0.9f, 0.1f, 0.1f);
+    r.drawSolidInstances(magnetShape, v.magnets.data(),
+                         (int)v.magnets.size());
+    r.color(0.2f, 0.8f, 1.0f);
+    r.drawSolidInstances(shieldShape, v.shields.data(),
+                         (int)v.shields.size());
+    r.color(0.6f, 0.2f, 0.9f);
+    r.drawSolidInstances(slowMotionShape, v.slowMotions.data(),
+                         (int)v.slowMotions.size());
+
+    r.setBlend(BLEND_ADDITIVE);
+    r.drawPointArray(v.coinXyz.data(), v.coinRgba.data(),
+                     (int)(v.coinXyz.size() / 3), 1.0f);
+    r.setBlend(BLEND_NONE);
+
+    r.popMatrix();
+}
+
+void drawWorld(Renderer& r) {
+    static WorldView view;
+    buildWorldView(view);
+    drawWorldView(r, view);
+}
+
+/* ========================================================================
+   PARTICLES
+   ======================================================================== */
+
+void drawParticleView(Renderer& r, const WorldView& v) {
+
+    if (v.particleCount == 0)
+        return;
+
+    r.setLighting(false);
+    r.setBlend(BLEND_ALPHA);
+
+    r.drawPointArray(v.particleXyz.data(), v.particleRgba.data(),
+                     v.particleCount, std::max(2.0f, r.height() / 270.0f));
+
+    r.setBlend(BLEND_NONE);
+    r.setLighting(true);
+}
+
+/* ========================================================================
+   FULL SCENE
+   ======================================================================== */
+
+void setSceneProjection(Renderer& r) {
+    r.setPerspective(45.0f,
+                     (float)r.width() / (float)r.height(),
+                     1.0f,
+                     300.0f);
+}
+
+void drawScene(Renderer& r) {
+
+    r.setCamera(0.0f, 4.0f, 6.0f,
+                0.0f, 0.0f, -8.0f,
+                0.0f, 1.0f, 0.0f);
+
+    r.setLightPosition(30.0f, 60.0f, 30.0f, 1.0f);
+
+    drawAttractiveBackground(r);
+
+    if (mode != MENU) {
+        static WorldView view;
+        buildWorldView(view);
+        drawWorldView(r, view);
+        drawRobot(r);
+        drawParticleView(r, view);
+    }
+}
+
+/* ========================================================================
+   SPLIT SCREEN
+   ======================================================================== */
+
+Viewport splitScreenViewport(int p, int players, int w, int h) {
+
+    if (players <= 1)
+        return { 0, 0, w, h };
+
+    int left = w / 2;
+
+    if (players == 2)
+        return p == 0 ? Viewport{ 0, 0, left, h }
+                      : Viewport{ left, 0, w - left, h };
+
+    int bottom = h / 2;
+    int x = (p % 2) ? left : 0;
+    int cw = (p % 2) ? w - left : left;
+
+    return p < 2 ? Viewport{ x, bottom, cw, h - bottom }
+                 : Viewport{ x, 0, cw, bottom };
+}
+
+void drawSplitScene(Renderer& r, int players, int w, int h) {
+
+    static WorldView view;
+    if (mode != MENU)
+        buildWorldView(view);
+
+    for (int p = 0; p < players; p++) {
+
+        Viewport vp = splitScreenViewport(p, players, w, h);
+        r.setViewport(vp.x, vp.y, vp.w, vp.h);
+        setSceneProjection(r);
+
+        float x = playerState(p).x;
+        r.setCamera(x, 4.0f, 6.0f,
+                    x, 0.0f, -8.0f,
+                    0.0f, 1.0f, 0.0f);
+
+        r.setLightPosition(30.0f, 60.0f, 30.0f, 1.0f);
+
+        drawAttractiveBackground(r);
+
+        if (mode == MENU)
+            continue;
+
+        drawWorldView(r, view);
+        for (int q = 0; q < players; q++) {
+            Runner s = playerState(q);
+            if (!s.out)
+                drawRunner(r, s.x, s.y, s.shield > 0.0f);
+        }
+        drawParticleView(r, view);
+    }
+
+    r.setViewport(0, 0, 0, 0);
+    setSceneProjection(r);
+}
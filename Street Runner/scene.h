@@ -0,0 +1,91 @@
+#ifndef STREET_RUNNER_SCENE_H
+#define STREET_RUNNER_SCENE_H
+
+#include "renderer.h"
+
+#include <vector>
+
+/* ========================================================================
+   SCENE DRAWING
+   ========================================================================
+   Everything the game draws apart from the HUD text. Backend-agnostic:
+   the GL window and the software rasterizer both feed these the same
+   Renderer calls.
+   ======================================================================== */
+
+void drawLineDDA(Renderer& r,
+                 float x1, float y1, float z1,
+                 float x2, float y2, float z2);
+void drawMidpointCirclePoints(Renderer& r, int radius, float pixelScale);
+void drawFilledMidpointCircle(Renderer& r, int radius, float scale);
+
+void drawAttractiveBackground(Renderer& r);
+void drawWorld(Renderer& r);
+void drawRobot(Renderer& r);
+
+/* The robot and its shadow at an explicit position, in a bubble when
+   shielded (drawRobot() uses the current player's). */
+void drawRunner(Renderer& r, float x, float y, bool shielded);
+
+/* ========================================================================
+   WORLD VIEW
+   ========================================================================
+   Everything drawWorld() and the particles submit for one tick: the
+   ground and lane stripes as arrays, scenery picked from the cache,
+   cars and coins culled to the view range and every batched instance
+   matrix already composed. It depends only on the game state, not on
+   the camera, so one build serves every viewport of a frame and each
+   extra viewport costs just the draw calls.
+   ======================================================================== */
+
+struct WorldView {
+    float roadOffset;
+
+    /* Road and grass, lit triangles. */
+    std::vector<float> groundXyz, groundNormals, groundRgba;
+
+    /* Lane stripes, unlit points. */
+    std::vector<float> stripeXyz, stripeRgba;
+
+    std::vector<Mat4> trunks, crowns;
+    std::vector<Mat4> carBodies, carRoofs, carWheels;
+
+    std::vector<float> coinXyz, coinRgba;
+
+    std::vector<Mat4> magnets, shields, slowMotions;
+
+    /* Scenery still drawn piece by piece, as x, z pairs. */
+    std::vector<float> windmills, houses, characters;
+
+    int particleCount;
+    std::vector<float> particleXyz, particleRgba;
+};
+
+void buildWorldView(WorldView& v);
+
+/* World, then particles, as of the last buildWorldView(). */
+void drawWorldView(Renderer& r, const WorldView& v);
+void drawParticleView(Renderer& r, const WorldView& v);
+
+/* The 45 degree camera projection, sized to the renderer. */
+void setSceneProjection(Renderer& r);
+
+/* Camera, light, sky and, outside the menu, world and robot. */
+void drawScene(Renderer& r);
+
+/* ========================================================================
+   SPLIT SCREEN
+   ======================================================================== */
+
+struct Viewport { int x, y, w, h; };
+
+/* Player p's share of a w x h target, bottom-left origin: two players
+   side by side, three or four in a 2 x 2 grid (P1 top left). */
+Viewport splitScreenViewport(int p, int players, int w, int h);
+
+/* drawScene() once per player (see game.h), each viewport with its
+   camera behind its own runner. The world is built once for all of
+   them. Leaves the viewport at the whole target. */
+void drawSplitScene(Renderer& r, int players, int w, int h);
+
+#endif
@@ -0,0 +1,440 @@
+#include "snapshot.h"
+#include "game.h"
+#include "traffic.h"
+#include "particles.h"
+#include "spatial.h"
+#include "reachability.h"
+
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+const uint32_t snapshotMagic = 0x34535253u;   /* "SRS4" */
+
+/* Coins are stored as two bits per lane (present, collected) in a ring
+   of segments indexed by segment number, so a coin keeps its byte
+   position from one tick to the next. The live coin window is
+   currentSegment - 1 up to the spawn horizon. */
+const int coinSlots = 128;
+
+inline int coinSlotBytes(int lanes) { return (2 * lanes + 7) / 8; }
+
+/* A segment holds at most one power-up; it takes a uint16_t in a ring
+   like the coins': present, collected, kind (2 bits), lane (6 bits). */
+const int powerUpSlotBytes = 2;
+
+template <typename T>
+inline void put(std::vector<uint8_t>& out, const T& v) {
+    size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(&out[at], &v, sizeof(T));
+}
+
+inline void putArray(std::vector<uint8_t>& out, const void* p, size_t n) {
+    size_t at = out.size();
+    out.resize(at + n);
+    if (n)
+        std::memcpy(&out[at], p, n);
+}
+
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    bool take(void* dst, size_t n) {
+        if ((size_t)(end - p) < n)
+            return false;
+        if (n)
+            std::memcpy(dst, p, n);
+        p += n;
+        return true;
+    }
+
+    template <typename T>
+    bool get(T& v) { return take(&v, sizeof(T)); }
+};
+
+}
+
+/* ========================================================================
+   SNAPSHOTS
+   ======================================================================== */
+
+void saveSnapshot(std::vector<uint8_t>& out) {
+
+    const TrafficPool& t = traffic;
+    const int32_t cars = t.count;
+    const int slotBytes = coinSlotBytes(laneCount);
+
+    out.clear();
+    out.reserve(96 + cars * 22 +
+                coinSlots * (slotBytes + powerUpSlotBytes));
+
+    put(out, snapshotMagic);
+    put(out, (uint8_t)mode);
+    put(out, (uint8_t)laneCount);
+    put(out, (uint8_t)currentLane);
+    put(out, (uint8_t)isJumping);
+
+    put(out, (int64_t)distanceScore);
+    put(out, (int64_t)coinScore);
+    put(out, (int64_t)currentSegment);
+
+    put(out, roadOffset);
+    put(out, scrollSpeed);
+    put(out, laneSpeed);
+    put(out, playerX);
+    put(out, playerY);
+    put(out, targetX);
+    put(out, velY);
+    put(out, windmillAngle);
+    put(out, countdownValue);
+    put(out, dayCycle);
+    put(out, magnetTime);
+    put(out, shieldTime);
+    put(out, slowMotionTime);
+
+    put(out, t.rng);
+    put(out, cars);
+    putArray(out, t.x, cars * sizeof(float));
+    putArray(out, t.z, cars * sizeof(float));
+    putArray(out, t.speed, cars * sizeof(float));
+    putArray(out, t.targetX, cars * sizeof(float));
+    putArray(out, t.laneTimer, cars * sizeof(float));
+    for (int i = 0; i < cars; i++)
+        put(out, (uint8_t)t.lane[i]);
+    for (int i = 0; i < cars; i++)
+        put(out, (uint8_t)t.nextLane[i]);
+
+    size_t ring = out.size();
+    out.resize(ring + coinSlots * slotBytes, 0);
+    for (const Coin& c : coins) {
+        if (c.seg < currentSegment - 1 ||
+            c.seg >= currentSegment - 1 + coinSlots)
+            continue;
+        int bit = 2 * c.lane;
+        uint8_t* slot = &out[ring + (c.seg & (coinSlots - 1)) * slotBytes];
+        slot[bit >> 3] |= (uint8_t)((1 | (c.collected ? 2 : 0)) << (bit & 7));
+    }
+
+    ring = out.size();
+    out.resize(ring + coinSlots * powerUpSlotBytes, 0);
+    for (const PowerUp& p : powerUps) {
+        if (p.seg < currentSegment - 1 ||
+            p.seg >= currentSegment - 1 + coinSlots)
+            continue;
+        uint16_t v = (uint16_t)(1 | (p.collected ? 2 : 0) |
+                                p.kind << 2 | p.lane << 4);
+        std::memcpy(&out[ring + (p.seg & (coinSlots - 1)) * powerUpSlotBytes],
+                    &v, sizeof(v));
+    }
+}
+
+bool loadSnapshot(const uint8_t* data, size_t size) {
+
+    Reader in = { data, data + size };
+
+    uint32_t magic;
+    uint8_t m, lanes, lane, jumping;
+    int64_t dist, coinsTaken, seg;
+    float f[13];
+    uint32_t rng;
+    int32_t cars;
+
+    if (!in.get(magic) || magic != snapshotMagic ||
+        !in.get(m) || m > COUNTDOWN ||
+        !in.get(lanes) || lanes < 1 || lanes > maxLanes ||
+        !in.get(lane) || lane >= lanes ||
+        !in.get(jumping) ||
+        !in.get(dist) || !in.get(coinsTaken) || !in.get(seg) ||
+        !in.take(f, sizeof(f)) ||
+        !in.get(rng) || !in.get(cars) || cars < 0 || cars > maxCars)
+        return false;
+
+    /* Everything is checked before any global is touched; a car lane
+       past laneCount would be shifted out of the reachability masks. */
+    const size_t carBytes = (size_t)cars * 22;
+    const uint8_t* carData = in.p;
+    if ((size_t)(in.end - in.p) < carBytes)
+        return false;
+    for (int i = 0; i < 2 * cars; i++)
+        if (carData[(size_t)cars * 20 + i] >= lanes)
+            return false;
+    in.p += carBytes;
+
+    const int slotBytes = coinSlotBytes(lanes);
+    if ((size_t)(in.end - in.p) !=
+        (size_t)coinSlots * (slotBytes + powerUpSlotBytes))
+        return false;
+
+    const uint8_t* powerUpRing = in.p + coinSlots * slotBytes;
+    for (int s = 0; s < coinSlots; s++) {
+        uint16_t v;
+        std::memcpy(&v, powerUpRing + s * powerUpSlotBytes, sizeof(v));
+        if ((v & 1) && (((v >> 2) & 3) >= powerUpKinds ||
+                        ((v >> 4) & 63) >= lanes))
+            return false;
+    }
+
+    setLaneCount(lanes);
+    mode = (GameMode)m;
+    runners[0].out = mode == GAMEOVER;
+    markItemsMoved(ITEM_ALL);
+    currentLane = lane;
+    isJumping = jumping != 0;
+
+    distanceScore = (long)dist;
+    coinScore = (long)coinsTaken;
+    currentSegment = (long)seg;
+
+    roadOffset = f[0];
+    scrollSpeed = f[1];
+    laneSpeed = f[2];
+    playerX = f[3];
+    playerY = f[4];
+    targetX = f[5];
+    velY = f[6];
+    windmillAngle = f[7];
+    countdownValue = f[8];
+    dayCycle = f[9];
+    magnetTime = f[10];
+    shieldTime = f[11];
+    slowMotionTime = f[12];
+
+    TrafficPool& t = traffic;
+    const size_t arrayBytes = (size_t)cars * sizeof(float);
+    t.rng = rng;
+    t.count = cars;
+    std::memcpy(t.x, carData, arrayBytes);
+    std::memcpy(t.z, carData + arrayBytes, arrayBytes);
+    std::memcpy(t.speed, carData + 2 * arrayBytes, arrayBytes);
+    std::memcpy(t.targetX, carData + 3 * arrayBytes, arrayBytes);
+    std::memcpy(t.laneTimer, carData + 4 * arrayBytes, arrayBytes);
+    for (int i = 0; i < cars; i++) {
+        t.lane[i] = carData[5 * arrayBytes + i];
+        t.nextLane[i] = carData[5 * arrayBytes + cars + i];
+    }
+
+    coins.clear();
+    for (long s = currentSegment - 1; s < currentSegment - 1 + coinSlots; s++) {
+        const uint8_t* slot = in.p + (s & (coinSlots - 1)) * slotBytes;
+        for (int l = 0; l < lanes; l++) {
+            int bits = slot[(2 * l) >> 3] >> ((2 * l) & 7);
+            if (bits & 1)
+                coins.push_back({ s, l, (bits & 2) != 0 });
+        }
+    }
+
+    powerUps.clear();
+    for (long s = currentSegment - 1; s < currentSegment - 1 + coinSlots; s++) {
+        uint16_t v;
+        std::memcpy(&v, powerUpRing + (s & (coinSlots - 1)) * powerUpSlotBytes,
+                    sizeof(v));
+        if (v & 1)
+            powerUps.push_back({ s, (v >> 4) & 63, (uint8_t)((v >> 2) & 3),
+                                 (v & 2) != 0 });
+    }
+
+    clearParticles();
+    rebuildReachability();
+    return true;
+}
+
+/* ========================================================================
+   REWIND
+   ======================================================================== */
+
+namespace {
+
+struct RewindFrame {
+    long tick;
+    std::vector<uint8_t> bytes;
+};
+
+std::vector<RewindFrame> rewindRing;
+long rewindHead = 0;                    /* tick of the next record */
+long rewindTail = 0;                    /* oldest tick still held */
+std::vector<uint8_t> rewindScratch;
+
+RewindFrame& frameAt(long tick) {
+    if (rewindRing.empty())
+        rewindRing.resize(rewindCapacity);
+    return rewindRing[tick % rewindCapacity];
+}
+
+inline long keyframeOf(long tick) {
+    return tick - tick % rewindKeyframeInterval;
+}
+
+inline void putVarint(std::vector<uint8_t>& out, size_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+inline bool getVarint(const uint8_t*& p, const uint8_t* end, size_t& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t b = *p++;
+        v |= (size_t)(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+/* XOR of target against base, byte-shuffled: first byte 0 of every
+   4-byte word, then byte 1, and so on. Snapshots are mostly 32-bit
+   fields, so the high bytes of floats that moved a little line up into
+   long zero runs. base is read as zeros past its end. */
+void shuffledXor(const std::vector<uint8_t>& base,
+                 const uint8_t* target, size_t n, uint8_t* out) {
+    const size_t nb = base.size();
+    size_t j = 0;
+    for (size_t plane = 0; plane < 4; plane++)
+        for (size_t i = plane; i < n; i += 4)
+            out[j++] = target[i] ^ (i < nb ? base[i] : 0);
+}
+
+void unshuffleXor(const std::vector<uint8_t>& base,
+                  const uint8_t* in, size_t n, uint8_t* target) {
+    const size_t nb = base.size();
+    size_t j = 0;
+    for (size_t plane = 0; plane < 4; plane++)
+        for (size_t i = plane; i < n; i += 4)
+            target[i] = in[j++] ^ (i < nb ? base[i] : 0);
+}
+
+std::vector<uint8_t> deltaScratch;
+
+/* out = size, then (zero run, literal run, literal bytes)* over the
+   shuffled XOR. */
+void encodeDelta(const std::vector<uint8_t>& base,
+                 const std::vector<uint8_t>& target,
+                 std::vector<uint8_t>& out) {
+
+    const size_t n = target.size();
+    deltaScratch.resize(n);
+    shuffledXor(base, target.data(), n, deltaScratch.data());
+    const uint8_t* d = deltaScratch.data();
+
+    out.clear();
+    putVarint(out, n);
+
+    size_t i = 0;
+    while (i < n) {
+        size_t zeros = i;
+        while (zeros < n && d[zeros] == 0)
+            zeros++;
+
+        /* A literal run ends at two zero bytes in a row; a lone zero is
+           cheaper to copy than to split the run for. */
+        size_t lit = zeros;
+        while (lit < n && !(d[lit] == 0 && (lit + 1 == n || d[lit + 1] == 0)))
+            lit++;
+
+        putVarint(out, zeros - i);
+        putVarint(out, lit - zeros);
+        out.insert(out.end(), d + zeros, d + lit);
+        i = lit;
+    }
+}
+
+bool decodeDelta(const std::vector<uint8_t>& base,
+                 const std::vector<uint8_t>& delta,
+                 std::vector<uint8_t>& out) {
+
+    const uint8_t* p = delta.data();
+    const uint8_t* end = p + delta.size();
+    size_t n;
+
+    if (!getVarint(p, end, n) || n > (size_t)1 << 28)
+        return false;
+    deltaScratch.assign(n, 0);
+
+    size_t i = 0;
+    while (i < n) {
+        size_t zeros, lit;
+        if (!getVarint(p, end, zeros) || !getVarint(p, end, lit) ||
+            zeros > n - i || lit > n - i - zeros ||
+            (size_t)(end - p) < lit)
+            return false;
+        i += zeros;
+        std::memcpy(&deltaScratch[i], p, lit);
+        p += lit;
+        i += lit;
+    }
+
+    out.resize(n);
+    unshuffleXor(base, deltaScratch.data(), n, out.data());
+    return true;
+}
+
+}
+
+void clearRewind() {
+    rewindHead = 0;
+    rewindTail = 0;
+}
+
+void recordRewind() {
+
+    const long tick = rewindHead++;
+    rewindTail = std::max(rewindTail, rewindHead - rewindCapacity);
+    RewindFrame& f = frameAt(tick);
+    f.tick = tick;
+
+    if (tick == keyframeOf(tick)) {
+        saveSnapshot(f.bytes);
+        return;
+    }
+
+    saveSnapshot(rewindScratch);
+    encodeDelta(frameAt(keyframeOf(tick)).bytes, rewindScratch, f.bytes);
+}
+
+long rewindAvailable() {
+
+    if (rewindHead == 0)
+        return 0;
+
+    /* The oldest frame still usable is the first one whose keyframe
+       has not been overwritten. */
+    long oldest = rewindTail;
+    if (oldest != keyframeOf(oldest))
+        oldest = keyframeOf(oldest) + rewindKeyframeInterval;
+
+    return std::max(0L, rewindHead - 1 - oldest);
+}
+
+bool rewindTicks(long ticks) {
+
+    if (ticks < 0 || ticks > rewindAvailable() || rewindHead == 0)
+        return false;
+
+    const long tick = rewindHead - 1 - ticks;
+    const RewindFrame& f = frameAt(tick);
+    bool ok;
+
+    if (tick == keyframeOf(tick))
+        ok = loadSnapshot(f.bytes.data(), f.bytes.size());
+    else
+        ok = decodeDelta(frameAt(keyframeOf(tick)).bytes,
+                         f.bytes, rewindScratch) &&
+             loadSnapshot(rewindScratch.data(), rewindScratch.size());
+
+    if (ok)
+        rewindHead = tick + 1;
+    return ok;
+}
+
+size_t rewindBytes() {
+
+    size_t total = 0;
+    for (long t = rewindTail; t < rewindHead; t++)
+        total += frameAt(t).bytes.size();
+    return total;
+}
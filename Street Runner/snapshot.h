@@ -0,0 +1,58 @@
+#ifndef STREET_RUNNER_SNAPSHOT_H
+#define STREET_RUNNER_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* ========================================================================
+   SNAPSHOTS
+   ========================================================================
+   A snapshot is a compact byte image (native byte order) of all the
+   simulation needs to carry on bit-exactly: mode, scores, player,
+   road position, day cycle, lane count, the traffic pool, the coin
+   and power-up window and the power-up timers. Cars, planned lane
+   changes included, are stored as arrays rather than records so
+   consecutive snapshots line up byte for byte, which is what the
+   rewind deltas feed on.
+
+   Left out on purpose: the scenery cache (rebuilt from the segment
+   number), the reachability rows (rebuilt from the cars on the road
+   when the next segment is spawned, from every lane, so later cars are
+   not always placed as they were), particles (cosmetic; cleared on
+   load), the high score, the tuning knobs (carDensity, speeds) and
+   runners past the first.
+   ======================================================================== */
+
+void saveSnapshot(std::vector<uint8_t>& out);
+
+/* Returns false, leaving the game untouched, if data is not a valid
+   snapshot. */
+bool loadSnapshot(const uint8_t* data, size_t size);
+
+/* ========================================================================
+   REWIND
+   ========================================================================
+   recordRewind() keeps one snapshot per tick for the last
+   rewindCapacity ticks. Every rewindKeyframeInterval-th tick is stored
+   whole; the others are stored as the XOR against their keyframe with
+   runs of zero bytes collapsed, so a restore decodes at most one delta.
+   ======================================================================== */
+
+const int rewindCapacity = 600;         /* 10 s at 60 ticks per second */
+const int rewindKeyframeInterval = 30;
+
+void clearRewind();
+void recordRewind();
+
+/* How many ticks back rewindTicks() can currently go. */
+long rewindAvailable();
+
+/* Restores the state recorded `ticks` ticks before the latest one and
+   forgets everything after it. */
+bool rewindTicks(long ticks);
+
+/* Bytes held by the ring, keyframes and deltas together. */
+size_t rewindBytes();
+
+#endif
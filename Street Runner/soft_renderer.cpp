@@ -0,0 +1,682 @@
+#include "soft_renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+inline float clamp01(float v) { return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v); }
+
+inline uint32_t packRGBA(float r, float g, float b, float a) {
+    return  (uint32_t)(clamp01(r) * 255.0f + 0.5f)
+         | ((uint32_t)(clamp01(g) * 255.0f + 0.5f) << 8)
+         | ((uint32_t)(clamp01(b) * 255.0f + 0.5f) << 16)
+         | ((uint32_t)(clamp01(a) * 255.0f + 0.5f) << 24);
+}
+
+/* Writes one fragment, applying the packed blend mode. */
+inline void shade(uint32_t& dst, uint8_t state,
+                  float r, float g, float b, float a) {
+
+    BlendMode mode = (BlendMode)(state >> 1);
+
+    if (mode == BLEND_NONE) {
+        dst = packRGBA(r, g, b, a);
+        return;
+    }
+
+    const float k = 1.0f / 255.0f;
+    float dr = (dst & 0xff) * k;
+    float dg = ((dst >> 8) & 0xff) * k;
+    float db = ((dst >> 16) & 0xff) * k;
+    float da = (dst >> 24) * k;
+
+    a = clamp01(a);
+    float keep = (mode == BLEND_ALPHA) ? 1.0f - a : 1.0f;
+
+    dst = packRGBA(r * a + dr * keep,
+                   g * a + dg * keep,
+                   b * a + db * keep,
+                   a * a + da * keep);
+}
+
+/* The fixed-function lighting the game sets up in main(): global ambient
+   0.2, light ambient 0.4, diffuse 0.8, colour material on both. */
+const float LIGHT_AMBIENT = 0.2f + 0.4f;
+const float LIGHT_DIFFUSE = 0.8f;
+
+}
+
+/* ========================================================================
+   SETUP
+   ======================================================================== */
+
+SoftRenderer::SoftRenderer(int width, int height, int threads)
+    : fbWidth(0), fbHeight(0), tilesX(0), tilesY(0),
+      vpX(0), vpY(0), vpWidth(0), vpHeight(0),
+      clearPending(false), mvpDirty(true),
+      lighting(true), depthTest(true), blend(BLEND_NONE),
+      prim(PRIM_POINTS), pointSize(1), pendingCount(0),
+      pool(threads < 1 ? 1 : threads) {
+
+    curColor[0] = curColor[1] = curColor[2] = curColor[3] = 1.0f;
+    curNormal[0] = 0.0f; curNormal[1] = 0.0f; curNormal[2] = 1.0f;
+    lightEye[0] = 0.0f; lightEye[1] = 0.0f;
+    lightEye[2] = 1.0f; lightEye[3] = 0.0f;
+
+    projection = mat4Identity();
+    modelviewStack.push_back(mat4Identity());
+
+    resize(width, height);
+}
+
+void SoftRenderer::resize(int width, int height) {
+
+    fbWidth = std::max(1, width);
+    fbHeight = std::max(1, height);
+    tilesX = (fbWidth + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (fbHeight + TILE_SIZE - 1) / TILE_SIZE;
+
+    colorBuffer.assign((size_t)fbWidth * fbHeight, 0xff000000u);
+    depthBuffer.assign((size_t)fbWidth * fbHeight, 1.0f);
+    bins.assign((size_t)tilesX * tilesY, std::vector<uint32_t>());
+    setViewport(0, 0, 0, 0);
+}
+
+void SoftRenderer::setViewport(int x, int y, int w, int h) {
+
+    if (w <= 0 || h <= 0) {
+        x = y = 0;
+        w = fbWidth;
+        h = fbHeight;
+    }
+
+    vpX = std::max(0, x);
+    vpY = std::max(0, fbHeight - (y + h));
+    vpWidth = std::max(1, std::min(w, fbWidth - vpX));
+    vpHeight = std::max(1, std::min(h, fbHeight - vpY));
+}
+
+bool SoftRenderer::writePPM(const char* path) const {
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+
+    fprintf(f, "P6\n%d %d\n255\n", fbWidth, fbHeight);
+
+    std::vector<unsigned char> row((size_t)fbWidth * 3);
+    for (int y = 0; y < fbHeight; y++) {
+        const uint32_t* src = &colorBuffer[(size_t)y * fbWidth];
+        for (int x = 0; x < fbWidth; x++) {
+            row[x * 3 + 0] = (unsigned char)(src[x] & 0xff);
+            row[x * 3 + 1] = (unsigned char)((src[x] >> 8) & 0xff);
+            row[x * 3 + 2] = (unsigned char)((src[x] >> 16) & 0xff);
+        }
+        fwrite(row.data(), 1, row.size(), f);
+    }
+
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+/* ========================================================================
+   STATE AND MATRICES
+   ======================================================================== */
+
+void SoftRenderer::clear() {
+    triangles.clear();
+    points.clear();
+    for (auto& b : bins)
+        b.clear();
+    clearPending = true;
+}
+
+void SoftRenderer::setPerspective(float fovy, float aspect,
+                                  float zn, float zf) {
+    projection = mat4Perspective(fovy, aspect, zn, zf);
+    matricesChanged();
+}
+
+void SoftRenderer::beginOverlay() {
+    projectionStack.push_back(projection);
+    projection = mat4Ortho(0, (float)vpWidth, 0, (float)vpHeight, -1, 1);
+    modelviewStack.push_back(mat4Identity());
+    matricesChanged();
+}
+
+void SoftRenderer::endOverlay() {
+    if (modelviewStack.size() > 1)
+        modelviewStack.pop_back();
+    if (!projectionStack.empty()) {
+        projection = projectionStack.back();
+        projectionStack.pop_back();
+    }
+    matricesChanged();
+}
+
+void SoftRenderer::setCamera(float ex, float ey, float ez,
+                             float cx, float cy, float cz,
+                             float ux, float uy, float uz) {
+    modelviewStack.back() = mat4LookAt(ex, ey, ez, cx, cy, cz, ux, uy, uz);
+    matricesChanged();
+}
+
+void SoftRenderer::setLightPosition(float x, float y, float z, float w) {
+    Vec4 p = mat4Transform(modelview(), x, y, z, w);
+    lightEye[0] = p.x; lightEye[1] = p.y;
+    lightEye[2] = p.z; lightEye[3] = p.w;
+}
+
+void SoftRenderer::pushMatrix() {
+    modelviewStack.push_back(modelviewStack.back());
+}
+
+void SoftRenderer::popMatrix() {
+    if (modelviewStack.size() > 1) {
+        modelviewStack.pop_back();
+        matricesChanged();
+    }
+}
+
+void SoftRenderer::translate(float x, float y, float z) {
+    modelviewStack.back() =
+        mat4Multiply(modelviewStack.back(), mat4Translation(x, y, z));
+    matricesChanged();
+}
+
+void SoftRenderer::rotate(float angle, float x, float y, float z) {
+    modelviewStack.back() =
+        mat4Multiply(modelviewStack.back(), mat4Rotation(angle, x, y, z));
+    matricesChanged();
+}
+
+void SoftRenderer::scale(float x, float y, float z) {
+    modelviewStack.back() =
+        mat4Multiply(modelviewStack.back(), mat4Scaling(x, y, z));
+    matricesChanged();
+}
+
+void SoftRenderer::color(float r, float g, float b, float a) {
+    curColor[0] = r; curColor[1] = g; curColor[2] = b; curColor[3] = a;
+}
+
+void SoftRenderer::normal(float x, float y, float z) {
+    curNormal[0] = x; curNormal[1] = y; curNormal[2] = z;
+}
+
+uint8_t SoftRenderer::packState() const {
+    return (uint8_t)((depthTest ? STATE_DEPTH : 0) |
+                     ((int)blend << STATE_BLEND_SHIFT));
+}
+
+/* MVP plus the normal matrix (row-major cofactors of the modelview's
+   upper 3x3, i.e. its inverse transpose up to scale; normals are
+   renormalised per vertex). */
+void SoftRenderer::updateDerived() {
+
+    mvp = mat4Multiply(projection, modelview());
+
+    const float* m = modelview().m;
+    float a = m[0], b = m[4], c = m[8];
+    float d = m[1], e = m[5], f = m[9];
+    float g = m[2], h = m[6], i = m[10];
+
+    float det = a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+    float s = det < 0.0f ? -1.0f : 1.0f;
+
+    normalMatrix[0] = s * (e * i - f * h);
+    normalMatrix[1] = s * (f * g - d * i);
+    normalMatrix[2] = s * (d * h - e * g);
+    normalMatrix[3] = s * (c * h - b * i);
+    normalMatrix[4] = s * (a * i - c * g);
+    normalMatrix[5] = s * (b * g - a * h);
+    normalMatrix[6] = s * (b * f - c * e);
+    normalMatrix[7] = s * (c * d - a * f);
+    normalMatrix[8] = s * (a * e - b * d);
+
+    mvpDirty = false;
+}
+
+/* ========================================================================
+   VERTEX STAGE
+   ======================================================================== */
+
+void SoftRenderer::begin(PrimitiveType p) {
+    prim = p;
+    pendingCount = 0;
+}
+
+void SoftRenderer::end() {
+    pendingCount = 0;
+}
+
+void SoftRenderer::vertex(float x, float y, float z) {
+
+    if (mvpDirty)
+        updateDerived();
+
+    ClipVertex& v = pending[pendingCount++];
+
+    Vec4 c = mat4Transform(mvp, x, y, z, 1.0f);
+    v.x = c.x; v.y = c.y; v.z = c.z; v.w = c.w;
+
+    float shadeK = 1.0f;
+
+    if (lighting) {
+
+        const float* n = normalMatrix;
+        float nx = n[0] * curNormal[0] + n[1] * curNormal[1] + n[2] * curNormal[2];
+        float ny = n[3] * curNormal[0] + n[4] * curNormal[1] + n[5] * curNormal[2];
+        float nz = n[6] * curNormal[0] + n[7] * curNormal[1] + n[8] * curNormal[2];
+
+        float lx = lightEye[0], ly = lightEye[1], lz = lightEye[2];
+        if (lightEye[3] != 0.0f) {
+            Vec4 e = mat4Transform(modelview(), x, y, z, 1.0f);
+            lx = lx / lightEye[3] - e.x;
+            ly = ly / lightEye[3] - e.y;
+            lz = lz / lightEye[3] - e.z;
+        }
+
+        float nl = std::sqrt(nx * nx + ny * ny + nz * nz);
+        float ll = std::sqrt(lx * lx + ly * ly + lz * lz);
+        float ndl = (nl > 0.0f && ll > 0.0f)
+                  ? (nx * lx + ny * ly + nz * lz) / (nl * ll) : 0.0f;
+
+        shadeK = LIGHT_AMBIENT + LIGHT_DIFFUSE * std::max(0.0f, ndl);
+    }
+
+    v.r = clamp01(curColor[0] * shadeK);
+    v.g = clamp01(curColor[1] * shadeK);
+    v.b = clamp01(curColor[2] * shadeK);
+    v.a = curColor[3];
+
+    if (prim == PRIM_POINTS) {
+        emitPoint(pending[0]);
+        pendingCount = 0;
+    }
+    else if (prim == PRIM_TRIANGLES && pendingCount == 3) {
+        emitTriangle(pending[0], pending[1], pending[2]);
+        pendingCount = 0;
+    }
+    else if (prim == PRIM_QUADS && pendingCount == 4) {
+        emitTriangle(pending[0], pending[1], pending[2]);
+        emitTriangle(pending[0], pending[2], pending[3]);
+        pendingCount = 0;
+    }
+}
+
+/* ========================================================================
+   CLIPPING AND BINNING
+   ======================================================================== */
+
+void SoftRenderer::emitPoint(const ClipVertex& v) {
+
+    if (v.w <= 0.0f ||
+        v.x < -v.w || v.x > v.w ||
+        v.y < -v.w || v.y > v.w ||
+        v.z < -v.w || v.z > v.w)
+        return;
+
+    float iw = 1.0f / v.w;
+    float half = (pointSize - 1) * 0.5f;
+    int x = vpX + (int)std::floor((v.x * iw * 0.5f + 0.5f) * vpWidth - half);
+    int y = vpY + (int)std::floor((0.5f - v.y * iw * 0.5f) * vpHeight - half);
+
+    Point p;
+    p.x0 = std::max(x, vpX);
+    p.y0 = std::max(y, vpY);
+    p.x1 = std::min(x + pointSize, vpX + vpWidth) - 1;
+    p.y1 = std::min(y + pointSize, vpY + vpHeight) - 1;
+    if (p.x0 > p.x1 || p.y0 > p.y1)
+        return;
+
+    p.z = v.z * iw * 0.5f + 0.5f;
+    p.r = v.r; p.g = v.g; p.b = v.b; p.a = v.a;
+    p.state = packState();
+
+    uint32_t ref = POINT_REF | (uint32_t)points.size();
+    points.push_back(p);
+
+    int tx0 = p.x0 / TILE_SIZE;
+    int ty0 = p.y0 / TILE_SIZE;
+    int tx1 = p.x1 / TILE_SIZE;
+    int ty1 = p.y1 / TILE_SIZE;
+
+    for (int ty = ty0; ty <= ty1; ty++)
+        for (int tx = tx0; tx <= tx1; tx++)
+            bins[ty * tilesX + tx].push_back(ref);
+}
+
+void SoftRenderer::drawPointArray(const float* xyz, const float* rgba,
+                                  int count, float size) {
+
+    pointSize = std::max(1, (int)(size + 0.5f));
+
+    begin(PRIM_POINTS);
+    for (int i = 0; i < count; i++) {
+        color(rgba[i * 4], rgba[i * 4 + 1], rgba[i * 4 + 2], rgba[i * 4 + 3]);
+        vertex(xyz[i * 3], xyz[i * 3 + 1], xyz[i * 3 + 2]);
+    }
+    end();
+
+    pointSize = 1;
+}
+
+void SoftRenderer::drawTriangleArray(const float* xyz, const float* normals,
+                                     const float* rgba, int count) {
+
+    begin(PRIM_TRIANGLES);
+    for (int i = 0; i < count; i++) {
+        color(rgba[i * 4], rgba[i * 4 + 1], rgba[i * 4 + 2], rgba[i * 4 + 3]);
+        normal(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]);
+        vertex(xyz[i * 3], xyz[i * 3 + 1], xyz[i * 3 + 2]);
+    }
+    end();
+}
+
+/* Near-plane clip (z >= -w) by Sutherland-Hodgman; everything else is
+   handled by the screen-space bounding box and the per-pixel depth range
+   test. Triangles fully outside one frustum plane are dropped early. */
+void SoftRenderer::emitTriangle(const ClipVertex& a, const ClipVertex& b,
+                                const ClipVertex& c) {
+
+    if ((a.x >  a.w && b.x >  b.w && c.x >  c.w) ||
+        (a.x < -a.w && b.x < -b.w && c.x < -c.w) ||
+        (a.y >  a.w && b.y >  b.w && c.y >  c.w) ||
+        (a.y < -a.w && b.y < -b.w && c.y < -c.w) ||
+        (a.z >  a.w && b.z >  b.w && c.z >  c.w) ||
+        (a.z < -a.w && b.z < -b.w && c.z < -c.w))
+        return;
+
+    float da = a.z + a.w, db = b.z + b.w, dc = c.z + c.w;
+
+    if (da >= 0.0f && db >= 0.0f && dc >= 0.0f) {
+        setupTriangle(a, b, c);
+        return;
+    }
+
+    const ClipVertex* in[3] = { &a, &b, &c };
+    float d[3] = { da, db, dc };
+    ClipVertex out[4];
+    int n = 0;
+
+    for (int i = 0; i < 3; i++) {
+
+        const ClipVertex& p = *in[i];
+        const ClipVertex& q = *in[(i + 1) % 3];
+        float dp = d[i], dq = d[(i + 1) % 3];
+
+        if (dp >= 0.0f)
+            out[n++] = p;
+
+        if ((dp >= 0.0f) != (dq >= 0.0f)) {
+            float t = dp / (dp - dq);
+            ClipVertex& o = out[n++];
+            o.x = p.x + (q.x - p.x) * t;
+            o.y = p.y + (q.y - p.y) * t;
+            o.z = p.z + (q.z - p.z) * t;
+            o.w = p.w + (q.w - p.w) * t;
+            o.r = p.r + (q.r - p.r) * t;
+            o.g = p.g + (q.g - p.g) * t;
+            o.b = p.b + (q.b - p.b) * t;
+            o.a = p.a + (q.a - p.a) * t;
+        }
+    }
+
+    for (int i = 1; i + 1 < n; i++)
+        setupTriangle(out[0], out[i], out[i + 1]);
+}
+
+void SoftRenderer::setupTriangle(const ClipVertex& a, const ClipVertex& b,
+                                 const ClipVertex& c) {
+
+    const ClipVertex* v[3] = { &a, &b, &c };
+    float sx[3], sy[3], sz[3];
+
+    for (int k = 0; k < 3; k++) {
+        float iw = 1.0f / v[k]->w;
+        sx[k] = vpX + (v[k]->x * iw * 0.5f + 0.5f) * vpWidth;
+        sy[k] = vpY + (0.5f - v[k]->y * iw * 0.5f) * vpHeight;
+        sz[k] = v[k]->z * iw * 0.5f + 0.5f;
+    }
+
+    float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) -
+                 (sx[2] - sx[0]) * (sy[1] - sy[0]);
+    if (std::fabs(area) < 1e-8f)
+        return;
+
+    float minXf = std::min(sx[0], std::min(sx[1], sx[2]));
+    float maxXf = std::max(sx[0], std::max(sx[1], sx[2]));
+    float minYf = std::min(sy[0], std::min(sy[1], sy[2]));
+    float maxYf = std::max(sy[0], std::max(sy[1], sy[2]));
+
+    Triangle t;
+    t.minX = std::max(vpX, (int)std::floor(minXf));
+    t.minY = std::max(vpY, (int)std::floor(minYf));
+    t.maxX = std::min(vpX + vpWidth - 1, (int)std::ceil(maxXf));
+    t.maxY = std::min(vpY + vpHeight - 1, (int)std::ceil(maxYf));
+    if (t.minX > t.maxX || t.minY > t.maxY)
+        return;
+
+    /* Edge k is opposite vertex k: it is the barycentric weight of k
+       scaled by the area. */
+    float sign = area < 0.0f ? -1.0f : 1.0f;
+    float inv = 1.0f / (area * sign);
+
+    for (int k = 0; k < 3; k++) {
+        int i = (k + 1) % 3, j = (k + 2) % 3;
+        t.edge[k][0] = sign * -(sy[j] - sy[i]);
+        t.edge[k][1] = sign *  (sx[j] - sx[i]);
+        t.edge[k][2] = sign * ((sy[j] - sy[i]) * sx[i] -
+                               (sx[j] - sx[i]) * sy[i]);
+    }
+
+    auto plane = [&](float out[3], float a0, float a1, float a2) {
+        for (int c = 0; c < 3; c++)
+            out[c] = (t.edge[0][c] * a0 +
+                      t.edge[1][c] * a1 +
+                      t.edge[2][c] * a2) * inv;
+    };
+
+    plane(t.depth, sz[0], sz[1], sz[2]);
+    plane(t.rgba[0], a.r, b.r, c.r);
+    plane(t.rgba[1], a.g, b.g, c.g);
+    plane(t.rgba[2], a.b, b.b, c.b);
+    plane(t.rgba[3], a.a, b.a, c.a);
+
+    t.state = packState();
+
+    uint32_t ref = (uint32_t)triangles.size();
+    triangles.push_back(t);
+
+    for (int ty = t.minY / TILE_SIZE; ty <= t.maxY / TILE_SIZE; ty++)
+        for (int tx = t.minX / TILE_SIZE; tx <= t.maxX / TILE_SIZE; tx++)
+            bins[ty * tilesX + tx].push_back(ref);
+}
+
+/* ========================================================================
+   MESHES
+   ======================================================================== */
+
+const Mesh& SoftRenderer::cachedMesh(int kind, float a, float b, float c,
+                                     int i, int j) {
+
+    for (const MeshEntry& e : meshCache)
+        if (e.kind == kind && e.a == a && e.b == b && e.c == c &&
+            e.i == i && e.j == j)
+            return e.mesh;
+
+    MeshEntry e = { kind, a, b, c, i, j, Mesh() };
+    switch (kind) {
+        case SOLID_CUBE:     e.mesh = makeCube(a);                 break;
+        case SOLID_SPHERE:   e.mesh = makeSphere(a, i, j);         break;
+        case SOLID_CONE:     e.mesh = makeCone(a, b, i, j);        break;
+        case SOLID_CYLINDER: e.mesh = makeCylinder(a, b, c, i, j); break;
+        case SOLID_TORUS:    e.mesh = makeTorus(a, b, i, j);       break;
+    }
+    meshCache.push_back(e);
+    return meshCache.back().mesh;
+}
+
+void SoftRenderer::drawMesh(const Mesh& m) {
+
+    const float* p = m.positions.data();
+    const float* n = m.normals.data();
+
+    begin(PRIM_TRIANGLES);
+    for (int k = 0; k < m.vertexCount(); k++) {
+        normal(n[k * 3], n[k * 3 + 1], n[k * 3 + 2]);
+        vertex(p[k * 3], p[k * 3 + 1], p[k * 3 + 2]);
+    }
+    end();
+}
+
+void SoftRenderer::solidCube(float size) {
+    drawMesh(cachedMesh(SOLID_CUBE, size, 0, 0, 0, 0));
+}
+
+void SoftRenderer::solidSphere(float radius, int slices, int stacks) {
+    drawMesh(cachedMesh(SOLID_SPHERE, radius, 0, 0, slices, stacks));
+}
+
+void SoftRenderer::solidCone(float base, float height,
+                             int slices, int stacks) {
+    drawMesh(cachedMesh(SOLID_CONE, base, height, 0, slices, stacks));
+}
+
+void SoftRenderer::cylinder(float base, float top, float height,
+                            int slices, int stacks) {
+    drawMesh(cachedMesh(SOLID_CYLINDER, base, top, height, slices, stacks));
+}
+
+void SoftRenderer::solidTorus(float inner, float outer,
+                              int sides, int rings) {
+    drawMesh(cachedMesh(SOLID_TORUS, inner, outer, 0, sides, rings));
+}
+
+void SoftRenderer::drawSolidInstances(const SolidShape& shape,
+                                      const Mat4* models, int count) {
+
+    const Mesh& m = cachedMesh(shape.kind, shape.a, shape.b, shape.c,
+                               shape.i, shape.j);
+    const Mat4 base = modelview();
+
+    for (int k = 0; k < count; k++) {
+        modelviewStack.back() = mat4Multiply(base, models[k]);
+        matricesChanged();
+        drawMesh(m);
+    }
+
+    modelviewStack.back() = base;
+    matricesChanged();
+}
+
+/* ========================================================================
+   TILE RASTERIZATION
+   ======================================================================== */
+
+void SoftRenderer::finish() {
+    pool.parallelFor(tilesX * tilesY, [this](int tile) { rasterTile(tile); });
+    clearPending = false;
+}
+
+void SoftRenderer::rasterTile(int tile) {
+
+    int x0 = (tile % tilesX) * TILE_SIZE;
+    int y0 = (tile / tilesX) * TILE_SIZE;
+    int x1 = std::min(fbWidth, x0 + TILE_SIZE) - 1;
+    int y1 = std::min(fbHeight, y0 + TILE_SIZE) - 1;
+
+    if (clearPending) {
+        for (int y = y0; y <= y1; y++) {
+            size_t row = (size_t)y * fbWidth;
+            std::fill(&colorBuffer[row + x0], &colorBuffer[row + x1] + 1,
+                      0xff000000u);
+            std::fill(&depthBuffer[row + x0], &depthBuffer[row + x1] + 1,
+                      1.0f);
+        }
+    }
+
+    for (uint32_t ref : bins[tile]) {
+
+        if (ref & POINT_REF) {
+
+            const Point& p = points[ref & ~POINT_REF];
+
+            int px0 = std::max(p.x0, x0), px1 = std::min(p.x1, x1);
+            int py0 = std::max(p.y0, y0), py1 = std::min(p.y1, y1);
+
+            for (int y = py0; y <= py1; y++)
+                for (int x = px0; x <= px1; x++) {
+
+                    size_t idx = (size_t)y * fbWidth + x;
+
+                    if (p.state & STATE_DEPTH) {
+                        if (!(p.z < depthBuffer[idx]))
+                            continue;
+                        depthBuffer[idx] = p.z;
+                    }
+                    shade(colorBuffer[idx], p.state, p.r, p.g, p.b, p.a);
+                }
+            continue;
+        }
+
+        const Triangle& t = triangles[ref];
+
+        int minX = std::max(t.minX, x0), maxX = std::min(t.maxX, x1);
+        int minY = std::max(t.minY, y0), maxY = std::min(t.maxY, y1);
+        bool useDepth = (t.state & STATE_DEPTH) != 0;
+
+        for (int y = minY; y <= maxY; y++) {
+
+            float py = y + 0.5f;
+
+            /* Solve each edge for the covered span of this row instead of
+               testing every pixel of the bounding box. */
+            int sx0 = minX, sx1 = maxX;
+
+            for (int k = 0; k < 3 && sx0 <= sx1; k++) {
+
+                float a = t.edge[k][0];
+                float rest = t.edge[k][1] * py + t.edge[k][2];
+
+                if (a > 0.0f)
+                    sx0 = std::max(sx0, (int)std::ceil(-rest / a - 0.5f));
+                else if (a < 0.0f)
+                    sx1 = std::min(sx1, (int)std::floor(-rest / a - 0.5f));
+                else if (rest < 0.0f)
+                    sx1 = sx0 - 1;
+            }
+
+            if (sx0 > sx1)
+                continue;
+
+            float px = sx0 + 0.5f;
+            float z = t.depth[0] * px + t.depth[1] * py + t.depth[2];
+            float r = t.rgba[0][0] * px + t.rgba[0][1] * py + t.rgba[0][2];
+            float g = t.rgba[1][0] * px + t.rgba[1][1] * py + t.rgba[1][2];
+            float b = t.rgba[2][0] * px + t.rgba[2][1] * py + t.rgba[2][2];
+            float a = t.rgba[3][0] * px + t.rgba[3][1] * py + t.rgba[3][2];
+
+            size_t idx = (size_t)y * fbWidth + sx0;
+
+            for (int x = sx0; x <= sx1; x++, idx++) {
+
+                if (z >= 0.0f && z <= 1.0f &&
+                    (!useDepth || z < depthBuffer[idx])) {
+                    if (useDepth)
+                        depthBuffer[idx] = z;
+                    shade(colorBuffer[idx], t.state, r, g, b, a);
+                }
+
+                z += t.depth[0];
+                r += t.rgba[0][0];
+                g += t.rgba[1][0];
+                b += t.rgba[2][0];
+                a += t.rgba[3][0];
+            }
+        }
+    }
+}
@@ -0,0 +1,180 @@
+#ifndef STREET_RUNNER_SOFT_RENDERER_H
+#define STREET_RUNNER_SOFT_RENDERER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "renderer.h"
+#include "math3d.h"
+#include "meshes.h"
+#include "thread_pool.h"
+
+/* ========================================================================
+   SOFTWARE RENDERER
+   ========================================================================
+   CPU rasterizer for machines without a GL stack (thumbnails, replays,
+   visual tests). Renderer calls are transformed, lit per vertex, clipped
+   against the near plane and binned into 64x64 screen tiles on the
+   calling thread; finish() then rasterizes the tiles across a thread
+   pool into an RGBA8 colour buffer with a float depth buffer. Each tile
+   replays its bin in submission order, so blending and depth-less
+   overlay passes come out the same as in GL.
+
+   Usage per frame: clear(), drawScene(r), finish(), then read pixels().
+   ======================================================================== */
+
+class SoftRenderer : public Renderer {
+public:
+    SoftRenderer(int width, int height, int threads);
+
+    void resize(int width, int height);
+    int threadCount() const { return pool.size(); }
+
+    /* Rasterizes everything submitted since clear(). */
+    void finish();
+
+    /* RGBA8 (R in the low byte), top row first. */
+    const uint32_t* pixels() const { return colorBuffer.data(); }
+    bool writePPM(const char* path) const;
+
+    long trianglesBinned() const { return (long)triangles.size(); }
+    long pointsBinned() const { return (long)points.size(); }
+
+    int width() const override { return vpWidth; }
+    int height() const override { return vpHeight; }
+    void setViewport(int x, int y, int w, int h) override;
+
+    void clear() override;
+
+    void setPerspective(float fovy, float aspect,
+                        float zn, float zf) override;
+    void beginOverlay() override;
+    void endOverlay() override;
+
+    void setCamera(float ex, float ey, float ez,
+                   float cx, float cy, float cz,
+                   float ux, float uy, float uz) override;
+    void setLightPosition(float x, float y, float z, float w) override;
+
+    void setLighting(bool on) override { lighting = on; }
+    void setDepthTest(bool on) override { depthTest = on; }
+    void setBlend(BlendMode b) override { blend = b; }
+    void setLineWidth(float) override {}
+
+    void pushMatrix() override;
+    void popMatrix() override;
+    void translate(float x, float y, float z) override;
+    void rotate(float angle, float x, float y, float z) override;
+    void scale(float x, float y, float z) override;
+
+    void color(float r, float g, float b, float a) override;
+    void normal(float x, float y, float z) override;
+
+    void begin(PrimitiveType prim) override;
+    void vertex(float x, float y, float z) override;
+    void end() override;
+
+    void drawPointArray(const float* xyz, const float* rgba,
+                        int count, float size) override;
+    void drawTriangleArray(const float* xyz, const float* normals,
+                           const float* rgba, int count) override;
+
+    void solidCube(float size) override;
+    void solidSphere(float radius, int slices, int stacks) override;
+    void solidCone(float base, float height,
+                   int slices, int stacks) override;
+    void cylinder(float base, float top, float height,
+                  int slices, int stacks) override;
+    void solidTorus(float inner, float outer,
+                    int sides, int rings) override;
+    void drawSolidInstances(const SolidShape& shape,
+                            const Mat4* models, int count) override;
+
+    static const int TILE_SIZE = 64;
+
+private:
+    struct ClipVertex { float x, y, z, w; float r, g, b, a; };
+
+    /* Edge functions and attribute planes in screen space; a value v is
+       v[0] * px + v[1] * py + v[2] at pixel centre (px, py). */
+    struct Triangle {
+        float edge[3][3];
+        float depth[3];
+        float rgba[4][3];
+        int minX, minY, maxX, maxY;
+        uint8_t state;
+    };
+
+    /* A size x size square with its top-left pixel at (x, y). */
+    struct Point {
+        int x0, y0, x1, y1;     /* inclusive, clipped to the viewport */
+        float z;
+        float r, g, b, a;
+        uint8_t state;
+    };
+
+    enum { STATE_DEPTH = 1, STATE_BLEND_SHIFT = 1 };
+    static const uint32_t POINT_REF = 0x80000000u;
+
+    uint8_t packState() const;
+    const Mat4& modelview() const { return modelviewStack.back(); }
+    void matricesChanged() { mvpDirty = true; }
+    void updateDerived();
+
+    void emitTriangle(const ClipVertex& a, const ClipVertex& b,
+                      const ClipVertex& c);
+    void setupTriangle(const ClipVertex& a, const ClipVertex& b,
+                       const ClipVertex& c);
+    void emitPoint(const ClipVertex& v);
+
+    void drawMesh(const Mesh& m);
+    const Mesh& cachedMesh(int kind, float a, float b, float c,
+                           int i, int j);
+
+    void rasterTile(int tile);
+
+    int fbWidth, fbHeight;
+    int tilesX, tilesY;
+
+    /* Viewport, top-left origin like the buffers. Triangles and points
+       are clipped to it. */
+    int vpX, vpY, vpWidth, vpHeight;
+
+    std::vector<uint32_t> colorBuffer;
+    std::vector<float> depthBuffer;
+
+    std::vector<Triangle> triangles;
+    std::vector<Point> points;
+    std::vector<std::vector<uint32_t> > bins;
+    bool clearPending;
+
+    Mat4 projection;
+    std::vector<Mat4> projectionStack;
+    std::vector<Mat4> modelviewStack;
+    Mat4 mvp;
+    float normalMatrix[9];
+    bool mvpDirty;
+
+    float curColor[4];
+    float curNormal[3];
+    float lightEye[4];
+    bool lighting, depthTest;
+    BlendMode blend;
+
+    PrimitiveType prim;
+    int pointSize;
+    ClipVertex pending[4];
+    int pendingCount;
+
+    struct MeshEntry {
+        int kind;
+        float a, b, c;
+        int i, j;
+        Mesh mesh;
+    };
+    std::vector<MeshEntry> meshCache;
+
+    ThreadPool pool;
+};
+
+#endif
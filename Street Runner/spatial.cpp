@@ -0,0 +1,190 @@
+#include "spatial.h"
+#include "game.h"
+#include "traffic.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+/* gridRows cells of segmentLength along z, starting gridOrigin units
+   behind the camera; one column per lane. */
+const int gridRows = 128;
+const float gridOrigin = 16.0f;
+
+struct ItemGrid {
+    bool valid;
+    int columns;
+    float left;                           /* x of column 0's left edge */
+    int count;
+
+    int cellStart[maxLanes * gridRows + 1];
+    int cellKey[maxIndexedItems];
+
+    /* Sorted by cell after a rebuild. */
+    float x[maxIndexedItems];
+    float z[maxIndexedItems];
+    int index[maxIndexedItems];
+    uint8_t kind[maxIndexedItems];
+};
+
+/* Coins and power-ups only change when a segment scrolls in or out;
+   cars move every tick, so they get a grid of their own that is only
+   rebuilt when a query asks for cars. */
+ItemGrid pickupGrid;
+ItemGrid carGrid;
+
+/* Gathered in source order, then scattered into a grid by cell. */
+float rawX[maxIndexedItems];
+float rawZ[maxIndexedItems];
+int rawIndex[maxIndexedItems];
+uint8_t rawKind[maxIndexedItems];
+
+inline int columnOf(const ItemGrid& g, float x) {
+    int c = (int)std::floor((x - g.left) * (1.0f / laneWidth));
+    return std::min(std::max(c, 0), g.columns - 1);
+}
+
+inline int rowOf(float z) {
+    int r = (int)std::floor((gridOrigin - z) * (1.0f / segmentLength));
+    return std::min(std::max(r, 0), gridRows - 1);
+}
+
+inline void gather(int& n, uint8_t kind, int index, float x, float z) {
+    if (n == maxIndexedItems)
+        return;
+    rawX[n] = x;
+    rawZ[n] = z;
+    rawIndex[n] = index;
+    rawKind[n] = kind;
+    n++;
+}
+
+/* Counting sort of the n gathered items into g. */
+void fillGrid(ItemGrid& g, int n) {
+
+    g.columns = laneCount;
+    g.left = laneX(0) - laneWidth * 0.5f;
+    g.count = n;
+
+    const int cells = g.columns * gridRows;
+    std::fill(g.cellStart, g.cellStart + cells + 1, 0);
+
+    for (int i = 0; i < n; i++) {
+        g.cellKey[i] = rowOf(rawZ[i]) * g.columns + columnOf(g, rawX[i]);
+        g.cellStart[g.cellKey[i] + 1]++;
+    }
+
+    for (int c = 0; c < cells; c++)
+        g.cellStart[c + 1] += g.cellStart[c];
+
+    static int fill[maxLanes * gridRows];
+    std::copy(g.cellStart, g.cellStart + cells, fill);
+
+    for (int i = 0; i < n; i++) {
+        int k = fill[g.cellKey[i]]++;
+        g.x[k] = rawX[i];
+        g.z[k] = rawZ[i];
+        g.index[k] = rawIndex[i];
+        g.kind[k] = rawKind[i];
+    }
+
+    g.valid = true;
+}
+
+void rebuildPickups() {
+
+    int n = 0;
+
+    for (int i = 0; i < (int)coins.size(); i++)
+        if (!coins[i].collected)
+            gather(n, ITEM_COIN, i,
+                   laneX(coins[i].lane), segmentZ(coins[i].seg));
+
+    for (int i = 0; i < (int)powerUps.size(); i++)
+        if (!powerUps[i].collected)
+            gather(n, ITEM_POWERUP, i,
+                   laneX(powerUps[i].lane), segmentZ(powerUps[i].seg));
+
+    fillGrid(pickupGrid, n);
+}
+
+void rebuildCars() {
+
+    int n = 0;
+
+    for (int i = 0; i < traffic.count; i++)
+        gather(n, ITEM_CAR, i, traffic.x[i], traffic.z[i]);
+
+    fillGrid(carGrid, n);
+}
+
+/* Visits every item of a kind in mask in the cells of g overlapping
+   the box; test decides which of them are hits. */
+template <typename Test>
+int queryGrid(const ItemGrid& g,
+              float x0, float z0, float x1, float z1, unsigned mask,
+              ItemHit* hits, int found, int maxHits, Test test) {
+
+    const int c0 = columnOf(g, x0), c1 = columnOf(g, x1);
+    const int r0 = rowOf(z1), r1 = rowOf(z0);
+
+    for (int r = r0; r <= r1; r++) {
+        int from = g.cellStart[r * g.columns + c0];
+        int to = g.cellStart[r * g.columns + c1 + 1];
+        for (int k = from; k < to && found < maxHits; k++)
+            if ((g.kind[k] & mask) && test(g.x[k], g.z[k]))
+                hits[found++] = { g.kind[k], g.index[k], g.x[k], g.z[k] };
+    }
+    return found;
+}
+
+template <typename Test>
+int query(float x0, float z0, float x1, float z1, unsigned mask,
+          ItemHit* hits, int maxHits, Test test) {
+
+    int found = 0;
+
+    if (mask & (ITEM_COIN | ITEM_POWERUP)) {
+        if (!pickupGrid.valid)
+            rebuildPickups();
+        found = queryGrid(pickupGrid, x0, z0, x1, z1, mask,
+                          hits, found, maxHits, test);
+    }
+
+    if (mask & ITEM_CAR) {
+        if (!carGrid.valid)
+            rebuildCars();
+        found = queryGrid(carGrid, x0, z0, x1, z1, mask,
+                          hits, found, maxHits, test);
+    }
+
+    return found;
+}
+
+}
+
+void markItemsMoved(unsigned mask) {
+    if (mask & (ITEM_COIN | ITEM_POWERUP))
+        pickupGrid.valid = false;
+    if (mask & ITEM_CAR)
+        carGrid.valid = false;
+}
+
+int queryItemsInRadius(float x, float z, float radius, unsigned mask,
+                       ItemHit* hits, int maxHits) {
+    const float r2 = radius * radius;
+    return query(x - radius, z - radius, x + radius, z + radius,
+                 mask, hits, maxHits,
+                 [=](float ix, float iz) {
+                     return (ix - x) * (ix - x) + (iz - z) * (iz - z) <= r2;
+                 });
+}
+
+int queryItemsInBox(float x0, float z0, float x1, float z1, unsigned mask,
+                    ItemHit* hits, int maxHits) {
+    return query(x0, z0, x1, z1, mask, hits, maxHits,
+                 [=](float ix, float iz) {
+                     return ix >= x0 && ix <= x1 && iz >= z0 && iz <= z1;
+                 });
+}
@@ -0,0 +1,56 @@
+#ifndef STREET_RUNNER_SPATIAL_H
+#define STREET_RUNNER_SPATIAL_H
+
+#include <cstdint>
+
+/* ========================================================================
+   SPATIAL INDEX
+   ========================================================================
+   Coins, power-ups and cars on uniform grids of one lane by one
+   segment per cell, in the road frame (the one segmentZ() and
+   traffic.z use). A grid is rebuilt with a counting sort on the first
+   query after markItemsMoved() for its kinds. The game marks the cars
+   every tick and coins and power-ups when a segment scrolls by, and
+   most ticks ask for pickups only, so the car grid is rarely rebuilt.
+
+   Radius and box queries visit only the cells the shape overlaps and
+   test the exact positions of what is in them, so their cost depends
+   on how crowded that patch of road is, not on how many items there
+   are. Items past either end of the grid go into its end rows; that
+   costs those queries time but never changes an answer.
+
+   Each hit names the item's kind and its index in coins, powerUps or
+   the traffic pool as of the rebuild. Collected coins and power-ups
+   stay in until the next rebuild, so callers check the flag.
+   ======================================================================== */
+
+enum ItemKind : uint8_t {
+    ITEM_COIN = 1,
+    ITEM_POWERUP = 2,
+    ITEM_CAR = 4
+};
+
+const int maxIndexedItems = 16384;   /* past this, items are left out */
+
+struct ItemHit {
+    uint8_t kind;
+    int index;
+    float x, z;
+};
+
+const unsigned ITEM_ALL = ITEM_COIN | ITEM_POWERUP | ITEM_CAR;
+
+/* Invalidates the index for the kinds in mask after items of those
+   kinds moved, appeared or went away. */
+void markItemsMoved(unsigned mask);
+
+/* Items of the kinds in mask within radius of (x, z). Writes up to
+   maxHits of them and returns how many it wrote. */
+int queryItemsInRadius(float x, float z, float radius, unsigned mask,
+                       ItemHit* hits, int maxHits);
+
+/* Items of the kinds in mask with x0 <= x <= x1 and z0 <= z <= z1. */
+int queryItemsInBox(float x0, float z0, float x1, float z1, unsigned mask,
+                    ItemHit* hits, int maxHits);
+
+#endif
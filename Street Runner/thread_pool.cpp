@@ -0,0 +1,78 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int threads)
+    : job(nullptr), jobCount(0), nextIndex(0),
+      busyWorkers(0), generation(0), stopping(false) {
+
+    for (int i = 1; i < threads; i++)
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> g(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers)
+        t.join();
+}
+
+void ThreadPool::drain() {
+    for (;;) {
+        int i = nextIndex.fetch_add(1, std::memory_order_relaxed);
+        if (i >= jobCount)
+            break;
+        (*job)(i);
+    }
+}
+
+void ThreadPool::workerLoop() {
+
+    unsigned long seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> g(lock);
+            wake.wait(g, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+
+        drain();
+
+        std::lock_guard<std::mutex> g(lock);
+        if (--busyWorkers == 0)
+            done.notify_one();
+    }
+}
+
+void ThreadPool::parallelFor(int count,
+                             const std::function<void(int)>& fn) {
+
+    if (count <= 0)
+        return;
+
+    if (workers.empty() || count == 1) {
+        for (int i = 0; i < count; i++)
+            fn(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> g(lock);
+        job = &fn;
+        jobCount = count;
+        nextIndex.store(0, std::memory_order_relaxed);
+        busyWorkers = (int)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    drain();
+
+    std::unique_lock<std::mutex> g(lock);
+    done.wait(g, [&] { return busyWorkers == 0; });
+    job = nullptr;
+}
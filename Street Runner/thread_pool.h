@@ -0,0 +1,51 @@
+#ifndef STREET_RUNNER_THREAD_POOL_H
+#define STREET_RUNNER_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* ========================================================================
+   THREAD POOL
+   ========================================================================
+   A fixed set of workers for fork/join loops. parallelFor() hands out
+   indices from an atomic counter, the calling thread works alongside
+   the pool, and the call returns once every index has been processed.
+   A pool of size 1 has no workers and runs everything inline.
+   ======================================================================== */
+
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /* Total threads taking part in parallelFor, caller included. */
+    int size() const { return (int)workers.size() + 1; }
+
+    void parallelFor(int count, const std::function<void(int)>& fn);
+
+private:
+    void workerLoop();
+    void drain();
+
+    std::vector<std::thread> workers;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(int)>* job;
+    int jobCount;
+    std::atomic<int> nextIndex;
+    int busyWorkers;
+    unsigned long generation;
+    bool stopping;
+};
+
+#endif
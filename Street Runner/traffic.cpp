@@ -0,0 +1,143 @@
+#include "traffic.h"
+#include "game.h"
+
+#include <cmath>
+#include <algorithm>
+
+TrafficPool traffic;
+
+namespace {
+
+const float laneChangeRate = 0.06f;  /* lateral units per tick */
+
+inline uint32_t nextRandom() {
+    uint32_t& s = traffic.rng;
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+}
+
+void removeCar(int i) {
+
+    TrafficPool& t = traffic;
+    int j = --t.count;
+    t.x[i] = t.x[j];
+    t.z[i] = t.z[j];
+    t.speed[i] = t.speed[j];
+    t.targetX[i] = t.targetX[j];
+    t.laneTimer[i] = t.laneTimer[j];
+    t.lane[i] = t.lane[j];
+    t.nextLane[i] = t.nextLane[j];
+}
+
+void clearTraffic() {
+    traffic.count = 0;
+    traffic.rng = 0x6C8E9CF5u;
+}
+
+int addCar(long seg, int lane, uint32_t seed) {
+
+    TrafficPool& t = traffic;
+    if (t.count >= maxCars)
+        return -1;
+
+    int i = t.count++;
+    t.x[i] = t.targetX[i] = laneX(lane);
+    t.z[i] = segmentZ(seg);
+    t.speed[i] = minCarSpeed + (seed & 7) * 0.01f;
+    t.laneTimer[i] = 60.0f + (float)((seed >> 3) % 240);
+    t.lane[i] = t.nextLane[i] = lane;
+
+    if (laneCount > 1) {
+        int to = lane + ((nextRandom() & 1) ? 1 : -1);
+        if (to < 0 || to >= laneCount)
+            to = 2 * lane - to;
+        t.nextLane[i] = to;
+    }
+    return i;
+}
+
+void rebaseTraffic(float dz) {
+
+    float* __restrict z = traffic.z;
+    const int n = traffic.count;
+
+    for (int i = 0; i < n; i++)
+        z[i] += dz;
+}
+
+void updateTraffic(float timeScale) {
+
+    TrafficPool& t = traffic;
+    const int n = t.count;
+
+    for (int i = 0; i < n; i++) {
+        t.laneTimer[i] -= timeScale;
+        if (t.laneTimer[i] <= 0.0f && t.nextLane[i] != t.lane[i]) {
+            t.lane[i] = t.nextLane[i];
+            t.targetX[i] = laneX(t.lane[i]);
+        }
+    }
+
+    {
+        float* __restrict x = t.x;
+        float* __restrict z = t.z;
+        const float* __restrict speed = t.speed;
+        const float* __restrict targetX = t.targetX;
+        const float step = laneChangeRate * timeScale;
+
+        for (int i = 0; i < n; i++) {
+            z[i] -= speed[i] * timeScale;
+            float dx = targetX[i] - x[i];
+            x[i] += std::min(std::max(dx, -step), step);
+        }
+    }
+
+    for (int i = 0; i < t.count; )
+        if (t.z[i] + roadOffset > cullBehind)
+            removeCar(i);
+        else
+            i++;
+}
+
+int carSpans(int i, CarSpan* out) {
+
+    const TrafficPool& t = traffic;
+    const float forever = 1e30f;
+    const float slide = laneWidth / laneChangeRate;
+
+    if (t.nextLane[i] != t.lane[i]) {
+        float at = std::max(t.laneTimer[i], 0.0f);
+        out[0] = { t.lane[i], 0.0f, at + 1.0f + slide };
+        out[1] = { t.nextLane[i], at, forever };
+        return 2;
+    }
+
+    out[0] = { t.lane[i], 0.0f, forever };
+    if (t.x[i] == t.targetX[i])
+        return 1;
+
+    /* Still sliding over from the lane it left. */
+    int from = t.lane[i] + (t.x[i] < t.targetX[i] ? -1 : 1);
+    float left = std::fabs(t.targetX[i] - t.x[i]) / laneChangeRate;
+    out[1] = { from, 0.0f, left + 1.0f };
+    return 2;
+}
+
+int carsHittingPlayer() {
+
+    const TrafficPool& t = traffic;
+    const int n = t.count;
+    const float px = laneX(currentLane);
+    const float halfLane = laneWidth * 0.5f;
+    int hits = 0;
+
+    for (int i = 0; i < n; i++)
+        hits += (std::fabs(t.z[i] + roadOffset) < carHitReach) &
+                (std::fabs(t.x[i] - px) < halfLane);
+
+    return hits;
+}
@@ -0,0 +1,84 @@
+#ifndef STREET_RUNNER_TRAFFIC_H
+#define STREET_RUNNER_TRAFFIC_H
+
+#include <cstdint>
+
+/* ========================================================================
+   TRAFFIC
+   ========================================================================
+   Cars drive down the road at their own speed and change lanes once on
+   the way. They live in a fixed-capacity structure-of-arrays pool
+   (spawning past capacity drops the car) and are advanced with flat
+   loops the compiler vectorizes.
+
+   A car's whole way is known when it is spawned, out at the far end of
+   the drawn road: its speed, and the lane it moves over to laneTimer
+   ticks later. Nothing changes it afterwards, so cars never brake or
+   cut in; reachability.h picks the speed and the lane change so that
+   no car runs into another and the runner always has a way through.
+
+   z is in the road frame relative to currentSegment (the same frame
+   segmentZ() returns), so it is shifted by segmentLength whenever the
+   player crosses into the next segment.
+   ======================================================================== */
+
+const int maxCars = 8192;
+
+struct TrafficPool {
+    int count;
+    uint32_t rng;                          /* lane-change directions */
+
+    alignas(32) float x[maxCars];
+    alignas(32) float z[maxCars];
+    alignas(32) float speed[maxCars];
+    alignas(32) float targetX[maxCars];    /* centre of lane[] */
+    alignas(32) float laneTimer[maxCars];  /* ticks to the lane change */
+    alignas(32) int32_t lane[maxCars];
+    alignas(32) int32_t nextLane[maxCars]; /* lane[] if it stays put */
+};
+
+extern TrafficPool traffic;
+
+const float cullBehind = 12.0f;      /* camera-relative z to drop at */
+const float minCarSpeed = 0.02f;
+const float maxCarSpeed = 0.09f;
+
+void clearTraffic();
+
+/* Adds a car parked at the centre of lane in segment seg and returns
+   its index, or -1 if the pool is full. The speed and when it changes
+   lane are derived from seed, which way from rng. */
+int addCar(long seg, int lane, uint32_t seed);
+
+/* Calls off car i's lane change. */
+inline void keepLane(int i) { traffic.nextLane[i] = traffic.lane[i]; }
+
+/* Shifts every car by dz after currentSegment moves. */
+void rebaseTraffic(float dz);
+
+/* One 16 ms step: change lanes when due, move, and drop cars that have
+   passed behind the camera. timeScale below 1 slows the cars down
+   (slow motion); lane changes are timed and made in the same scaled
+   ticks, so a car's way along the road does not depend on it. */
+void updateTraffic(float timeScale = 1.0f);
+
+/* Drops car i; the last car in the pool takes its index. */
+void removeCar(int i);
+
+/* A lane a car is in, from and to a road time (ticks at the normal
+   rate) from now. */
+struct CarSpan {
+    int lane;
+    float from, to;
+};
+
+/* Car i's lanes from now on, into out; returns how many (1 or 2). A car
+   changing lane is counted in both for the whole slide, and the tick
+   the change falls on either side of. */
+int carSpans(int i, CarSpan* out);
+
+/* Number of cars overlapping a player standing in currentLane at the
+   camera plane; one flat pass over the pool. */
+int carsHittingPlayer();
+
+#endif